@@ -1,25 +1,31 @@
 #include <CLI/CLI.hpp>
 #include <iostream>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <optional>
 
 #include "command/log.hpp"
+#include "command/batch.hpp"
+#include "command/options.hpp"
+#include "command/watch.hpp"
 #include "storage/config.hpp"
 #include "storage/client.hpp"
+#include "storage/client_decoder.hpp"
+#include "storage/arena.hpp"
 
-static std::string normalize_month(const std::string &month)
+// Commands that only read client data (an invoice aside from bumping its
+// number) decode it on demand instead of through a JSON DOM.
+static bool is_read_only(const WlogOptions &opts)
 {
-    if (month.empty() || month.length() > 2)
-        return month;
-
-    auto now = std::chrono::system_clock::now();
-    auto now_time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&now_time);
-    int month_num = std::stoi(month);
-    std::ostringstream oss;
-    oss << (1900 + tm.tm_year) << "-" << std::setfill('0') << std::setw(2) << month_num;
-    return oss.str();
+    if (!opts.export_format.empty() || !opts.search.empty() || !opts.query.empty() || !opts.merge.empty() ||
+        opts.watch)
+        return true;
+    return !opts.setup && opts.hours <= 0 && (opts.show || opts.report || opts.invoice);
+}
+
+// Commands that load every client's whole history one client at a time; an
+// arena would hold on to all of them until the command ends.
+static bool loads_client_by_client(const WlogOptions &opts)
+{
+    return !opts.sync.empty() || (opts.setup && !opts.from.empty()) || (opts.all && opts.invoice);
 }
 
 int main(int argc, char **argv)
@@ -27,25 +33,96 @@ int main(int argc, char **argv)
     CLI::App app{"Work logger - log hours and generate invoices"};
     app.usage("wlog <client> <hours> <message> [date]\n"
               "       wlog <client> [OPTIONS]\n"
-              "       wlog --setup [client]");
+              "       wlog --all --show [OPTIONS]\n"
+              "       wlog --all --invoice [-m MONTH]\n"
+              "       wlog --clients\n"
+              "       wlog [client] --archive\n"
+              "       wlog [client] --export csv|jsonl|columnar [-o file]\n"
+              "       wlog [client] --search \"terms\" [--from DATE --to DATE]\n"
+              "       wlog --query \"sum(hours) where tag = X by month\"\n"
+              "       wlog <client> --merge DIR --merge DIR [-m MONTH] [-i|-r]\n"
+              "       wlog --sync DIR\n"
+              "       wlog --backup DEST | --snapshots DEST\n"
+              "       wlog --restore DEST [--snapshot NAME]\n"
+              "       wlog --watch\n"
+              "       wlog --batch [--checkpoint N] < commands\n"
+              "       wlog --setup [client]\n"
+              "       wlog --setup --from clients.json|-");
 
     WlogOptions opts;
-
-    app.add_flag("--setup", opts.setup, "Run business or client setup");
-    app.add_option("client", opts.client, "Client identifier");
-    app.add_option("hours", opts.hours, "Hours worked");
-    app.add_option("message", opts.message, "Work description");
-    app.add_option("date", opts.day, "Date (YYYY-MM-DD), defaults to today");
-    app.add_flag("--invoice,-i", opts.invoice, "Generate invoice for previous month");
-    app.add_flag("--report,-r", opts.report, "Generate work log report");
-    app.add_option("--month,-m", opts.month, "Month for report (YYYY-MM), defaults to previous month");
-    app.add_flag("--show,-s", opts.show, "Show current month's work logs");
-    app.add_flag("--today,-t", opts.today_only, "Show only today's log (use with -s)");
+    add_options(app, opts);
 
     CLI11_PARSE(app, argc, argv);
 
     opts.month = normalize_month(opts.month);
 
+    if (ConfigManager::config_exists())
+        ConfigManager::apply_storage_config(ConfigManager::load().storage);
+    ClientDecoder::set_on_demand(is_read_only(opts));
+
+    // A batch session keeps clients loaded across commands, so it stays on the heap.
+    if (opts.batch)
+    {
+        try
+        {
+            return run_batch(std::cin, std::cout, parse_batch_line, opts.checkpoint);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Export frees each client before loading the next; an arena would keep them all.
+    if (!opts.export_format.empty())
+    {
+        try
+        {
+            run_export(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Watching reloads clients for as long as it runs; an arena would never shrink.
+    if (opts.watch)
+    {
+        try
+        {
+            run_watch();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Everything a command loads is released in one go when main returns.
+    std::optional<CommandArena> arena;
+    if (!loads_client_by_client(opts))
+        arena.emplace();
+
+    if (opts.setup && !opts.from.empty())
+    {
+        try
+        {
+            run_bulk_setup(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     if (opts.setup)
     {
         if (opts.client.empty())
@@ -64,6 +141,157 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    if (opts.list_clients)
+    {
+        run_list_clients();
+        return 0;
+    }
+
+    if (opts.archive)
+    {
+        try
+        {
+            run_archive(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (opts.reindex)
+    {
+        run_reindex();
+        return 0;
+    }
+
+    if (!opts.search.empty())
+    {
+        try
+        {
+            run_search(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!opts.query.empty())
+    {
+        try
+        {
+            run_query(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!opts.backup.empty())
+    {
+        try
+        {
+            run_backup(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!opts.restore.empty())
+    {
+        try
+        {
+            run_restore(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!opts.snapshots.empty())
+    {
+        try
+        {
+            run_list_snapshots(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!opts.sync.empty())
+    {
+        try
+        {
+            run_sync(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!opts.merge.empty())
+    {
+        if (opts.client.empty())
+        {
+            std::cerr << "--merge needs a client." << std::endl;
+            return 1;
+        }
+        try
+        {
+            run_merge(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (opts.all)
+    {
+        if (!opts.show && !opts.invoice)
+        {
+            std::cerr << "--all is only supported with --show or --invoice." << std::endl;
+            return 1;
+        }
+        try
+        {
+            if (opts.invoice)
+                run_invoice_all(opts);
+            else
+                run_show_all(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     if (opts.client.empty())
     {
         if (!ConfigManager::config_exists())
@@ -124,7 +352,15 @@ int main(int argc, char **argv)
 
     if (opts.show)
     {
-        run_show(opts);
+        try
+        {
+            run_show(opts);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
         return 0;
     }
 
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/client_decoder.hpp"
+#include "storage/durable_file.hpp"
+
+namespace fs = std::filesystem;
+
+static const char *const kMessages[] = {
+    "Standup", "Code review", "Sprint planning", "Retrospective",
+    "Backend API development for the billing module",
+    "Frontend work on the customer dashboard",
+    "Bug fixing and regression testing",
+    "Meeting with product owner about roadmap",
+    "Deployment and release preparation",
+    "Infrastructure maintenance",
+};
+
+static std::string write_client(int years)
+{
+    ClientData client;
+    client.name = "Bench Client";
+    client.tag = "BEN";
+    client.hourly_rate = 100.0;
+    for (int y = 0; y < years; y++)
+    {
+        for (int m = 1; m <= 12; m++)
+        {
+            for (int d = 1; d <= 28; d++)
+            {
+                char date[32];
+                std::snprintf(date, sizeof(date), "%04d-%02d-%02d", 2000 + y, m, d);
+                client.logs.set(date, 0.25 * (d % 32 + 1), kMessages[(d * 7 + m + y) % 10]);
+            }
+        }
+    }
+    ClientManager::save("bench", client);
+    return ClientManager::get_client_path("bench");
+}
+
+// Decodes the file iterations times and reports throughput over its size.
+template <typename Decode>
+static void run(const char *label, const std::string &path, int iterations, Decode decode)
+{
+    size_t rows = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        ClientData data = decode(path);
+        rows += data.logs.size();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double mb = static_cast<double>(fs::file_size(path)) * iterations / (1024.0 * 1024.0);
+    std::printf("%-10s %8zu rows  %8.1f MB/s  %8.2f ms/file\n", label, rows / iterations, mb / elapsed.count(),
+                elapsed.count() * 1000.0 / iterations);
+}
+
+static void compare(const std::string &path, int iterations)
+{
+    run("stream", path, iterations, [](const std::string &file_path) {
+        std::ifstream file(file_path);
+        nlohmann::json j;
+        file >> j;
+        return j.get<ClientData>();
+    });
+
+    ClientDecoder::set_on_demand(true);
+    run(ClientDecoder::get_on_demand() ? "on-demand" : "fallback", path, iterations,
+        [](const std::string &file_path) {
+            std::string contents;
+            DurableFile::read(file_path, contents);
+            return ClientDecoder::decode_client(contents);
+        });
+    ClientDecoder::set_on_demand(false);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+    int years = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    fs::path dir = fs::temp_directory_path() / "wlog_bench_decode";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    setenv("HOME", dir.c_str(), 1);
+    ConfigManager::ensure_directories();
+    DurableFile::set_policy(DurabilityPolicy::None);
+
+    std::string path = write_client(years);
+    std::printf("inline: %zu KiB\n", static_cast<size_t>(fs::file_size(path) / 1024));
+    compare(path, iterations);
+
+    WorkLogTable::set_encoding(MessageEncoding::Dictionary);
+    path = write_client(years);
+    std::printf("dictionary: %zu KiB\n", static_cast<size_t>(fs::file_size(path) / 1024));
+    compare(path, iterations);
+
+    fs::remove_all(dir);
+    return 0;
+}
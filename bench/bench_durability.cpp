@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/durable_file.hpp"
+
+namespace fs = std::filesystem;
+
+static std::string date_for(int i)
+{
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d", 2020 + i / 336, 1 + (i / 28) % 12, 1 + i % 28);
+    return buf;
+}
+
+static double run(DurabilityPolicy policy, const char *label, int entries, bool batched)
+{
+    DurableFile::set_policy(policy);
+
+    ClientData client;
+    client.name = "Bench Client";
+    client.tag = "BEN";
+    client.hourly_rate = 100.0;
+    ClientManager::save("bench", client);
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        WriteBatch batch;
+        for (int i = 0; i < entries; i++)
+        {
+            ClientManager::add_work_log("bench", date_for(i), 8.0, "Benchmark entry");
+            if (!batched)
+                batch.commit();
+        }
+        batch.commit();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double us = std::chrono::duration<double, std::micro>(elapsed).count() / entries;
+    std::printf("%-12s %-10s %6d entries  %10.1f us/entry\n", label, batched ? "batched" : "single", entries, us);
+    return us;
+}
+
+int main(int argc, char **argv)
+{
+    int entries = argc > 1 ? std::atoi(argv[1]) : 500;
+
+    fs::path dir = fs::temp_directory_path() / "wlog_bench_durability";
+    fs::create_directories(dir);
+    setenv("HOME", dir.c_str(), 1);
+    ConfigManager::ensure_directories();
+
+    run(DurabilityPolicy::None, "none", entries, false);
+    run(DurabilityPolicy::PerWrite, "per-write", entries, false);
+    run(DurabilityPolicy::PerBatch, "per-batch", entries, false);
+    run(DurabilityPolicy::PerBatch, "per-batch", entries, true);
+
+    fs::remove_all(dir);
+    return 0;
+}
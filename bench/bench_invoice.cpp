@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include "invoice/generator.hpp"
+
+namespace fs = std::filesystem;
+
+static InvoiceData invoice(int client)
+{
+    AppConfig config;
+    config.company.name = "Bench Company B.V.";
+    config.company.address_line1 = "Keizersgracht 1";
+    config.company.address_line2 = "1015 CJ Amsterdam";
+    config.company.kvk = "12345678";
+    config.company.btw = "NL123456789B01";
+    config.company.bank_account = "NL00BANK0123456789";
+    config.company.tag = "BEN";
+    config.company.currency = "EUR";
+    if (const char *logo = std::getenv("WLOG_BENCH_LOGO"))
+        config.company.logo_path = logo;
+
+    ClientData data;
+    data.name = "Client " + std::to_string(client);
+    data.address_line1 = "Street " + std::to_string(client);
+    data.address_line2 = "City";
+    data.hourly_rate = 80.0 + client % 40;
+    data.payment_term_days = 30;
+    data.tag = "C" + std::to_string(client);
+    return InvoiceGenerator::prepare_data(config, data, "2025-01", 20.0 + client % 100);
+}
+
+// Writes count invoices, with one template for all or a new one for each.
+static void run(const char *label, bool reuse, int count, const fs::path &dir)
+{
+    std::unique_ptr<InvoiceTemplate> layout;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        InvoiceData data = invoice(i);
+        if (!reuse || !layout)
+            layout = std::make_unique<InvoiceTemplate>(data);
+
+        PDFBuilder builder(data, *layout);
+        builder.build();
+        builder.save((dir / (data.invoice_number + ".pdf")).string());
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-8s %6d invoices  %8.3f ms/invoice\n", label, count, elapsed.count() / count);
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 500;
+
+    fs::path dir = fs::temp_directory_path() / "wlog_bench_invoice";
+    fs::create_directories(dir);
+
+    run("fresh", false, count, dir);
+    run("reused", true, count, dir);
+
+    fs::remove_all(dir);
+    return 0;
+}
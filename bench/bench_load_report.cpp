@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include "storage/arena.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/durable_file.hpp"
+#include "report/work_log.hpp"
+
+namespace fs = std::filesystem;
+
+static const char *const kMessages[] = {
+    "Standup", "Code review", "Backend API development for the billing module",
+    "Frontend work on the customer dashboard", "Bug fixing and regression testing",
+};
+
+static void generate(const std::string &id, int years)
+{
+    ClientData client;
+    client.name = "Bench Client " + id;
+    client.tag = "BCL";
+    client.hourly_rate = 100.0;
+    for (int y = 0; y < years; y++)
+    {
+        for (int m = 1; m <= 12; m++)
+        {
+            for (int d = 1; d <= 28; d++)
+            {
+                char date[32];
+                std::snprintf(date, sizeof(date), "%04d-%02d-%02d", 2020 + y, m, d);
+                client.logs.set(date, 8.0, kMessages[(d + m) % 5]);
+            }
+        }
+    }
+    ClientManager::save(id, client);
+}
+
+static size_t load_and_prepare()
+{
+    ClientData client = ClientManager::load("bench");
+    WorkLogReportData data = WorkLogReport::prepare_data("bench", "2021-06");
+    return client.logs.size() + data.entries.size();
+}
+
+// What --all and query do: every client parsed on the worker threads.
+static size_t load_all()
+{
+    size_t rows = 0;
+    for (const auto &[id, client] : BatchLoader::load_all())
+        rows += client.logs.size();
+    return rows;
+}
+
+static double run(const char *label, int iterations, bool arena, size_t (*work)())
+{
+    size_t rows = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        if (arena)
+        {
+            CommandArena scope;
+            rows += work();
+        }
+        else
+        {
+            rows += work();
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double us = std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+    std::printf("%-10s %6d iterations  %8zu rows  %10.1f us/iteration\n", label, iterations, rows, us);
+    return us;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+    int years = argc > 2 ? std::atoi(argv[2]) : 5;
+    int clients = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    fs::path dir = fs::temp_directory_path() / "wlog_bench_load_report";
+    fs::create_directories(dir);
+    setenv("HOME", dir.c_str(), 1);
+    ConfigManager::ensure_directories();
+    DurableFile::set_policy(DurabilityPolicy::None);
+
+    AppConfig config;
+    config.company.name = "Bench Co";
+    config.company.tag = "BEN";
+    ConfigManager::save(config);
+    generate("bench", years);
+
+    run("heap", iterations, false, load_and_prepare);
+    run("arena", iterations, true, load_and_prepare);
+
+    for (int c = 0; c < clients; c++)
+        generate("client" + std::to_string(c), 1);
+    int all_iterations = std::max(1, iterations / 20);
+    run("heap all", all_iterations, false, load_all);
+    run("arena all", all_iterations, true, load_all);
+
+    fs::remove_all(dir);
+    return 0;
+}
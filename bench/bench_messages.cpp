@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/durable_file.hpp"
+
+namespace fs = std::filesystem;
+
+static const char *const kMessages[] = {
+    "Standup", "Code review", "Sprint planning", "Retrospective",
+    "Backend API development for the billing module",
+    "Frontend work on the customer dashboard",
+    "Bug fixing and regression testing",
+    "Meeting with product owner about roadmap",
+    "Deployment and release preparation",
+    "Infrastructure maintenance",
+};
+
+static long resident_kb()
+{
+    long pages = 0;
+    FILE *f = std::fopen("/proc/self/statm", "r");
+    if (f)
+    {
+        if (std::fscanf(f, "%*s %ld", &pages) != 1)
+            pages = 0;
+        std::fclose(f);
+    }
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static void generate(int clients, int years)
+{
+    for (int c = 0; c < clients; c++)
+    {
+        ClientData client;
+        client.name = "Client " + std::to_string(c);
+        client.tag = "C" + std::to_string(c);
+        for (int y = 0; y < years; y++)
+        {
+            for (int m = 1; m <= 12; m++)
+            {
+                for (int d = 1; d <= 28; d++)
+                {
+                    if (d % 7 == 6 || d % 7 == 0)
+                        continue;
+                    char date[32];
+                    std::snprintf(date, sizeof(date), "%04d-%02d-%02d", 2020 + y, m, d);
+                    client.logs.set(date, 8.0, kMessages[(c + d * 7 + m) % 10]);
+                }
+            }
+        }
+        ClientManager::save("client" + std::to_string(c), client);
+    }
+}
+
+// Each measurement runs in a child so freed heap from one run cannot hide
+// the cost of the next.
+static void measure(const std::function<void()> &fn)
+{
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        fn();
+        std::fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+static void report(const char *label, long before, size_t rows, const std::set<const MessagePool *> &pools)
+{
+    size_t unique = 0;
+    size_t bytes = 0;
+    for (const MessagePool *pool : pools)
+    {
+        unique += pool->size();
+        bytes += pool->text_bytes();
+    }
+    std::printf("%-12s %8zu rows  %6zu pools  %8zu strings  %9zu text bytes  %8ld KiB resident\n",
+                label, rows, pools.size(), unique, bytes, resident_kb() - before);
+}
+
+int main(int argc, char **argv)
+{
+    int clients = argc > 1 ? std::atoi(argv[1]) : 100;
+    int years = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    fs::path dir = fs::temp_directory_path() / "wlog_bench_messages";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    setenv("HOME", dir.c_str(), 1);
+    ConfigManager::ensure_directories();
+    DurableFile::set_policy(DurabilityPolicy::None);
+
+    generate(clients, years);
+
+    size_t inline_bytes = 0;
+    size_t dictionary_bytes = 0;
+    for (const auto &entry : fs::directory_iterator(ConfigManager::get_clients_dir()))
+    {
+        inline_bytes += fs::file_size(entry.path());
+    }
+    WorkLogTable::set_encoding(MessageEncoding::Dictionary);
+    for (const std::string &id : BatchLoader::list_client_ids())
+    {
+        ClientManager::save(id, ClientManager::load(id));
+    }
+    for (const auto &entry : fs::directory_iterator(ConfigManager::get_clients_dir()))
+    {
+        dictionary_bytes += fs::file_size(entry.path());
+    }
+    std::printf("on disk: inline %zu KiB, dictionary %zu KiB\n", inline_bytes / 1024, dictionary_bytes / 1024);
+
+    std::vector<std::string> ids = BatchLoader::list_client_ids();
+
+    measure([&]() {
+        long before = resident_kb();
+        std::vector<ClientData> loaded;
+        std::set<const MessagePool *> pools;
+        size_t rows = 0;
+        for (const std::string &id : ids)
+        {
+            loaded.push_back(ClientManager::load(id));
+            rows += loaded.back().logs.size();
+            pools.insert(loaded.back().logs.pool().get());
+        }
+        report("per-client", before, rows, pools);
+    });
+
+    measure([&]() {
+        long before = resident_kb();
+        auto pool = std::make_shared<MessagePool>();
+        std::vector<ClientData> loaded;
+        std::set<const MessagePool *> pools;
+        size_t rows = 0;
+        for (const std::string &id : ids)
+        {
+            loaded.push_back(ClientManager::load(id));
+            loaded.back().logs.share_pool(pool);
+            rows += loaded.back().logs.size();
+            pools.insert(pool.get());
+        }
+        report("shared", before, rows, pools);
+    });
+
+    // What one std::string per row (the previous layout) would hold.
+    size_t per_row_bytes = 0;
+    for (const auto &[id, client] : BatchLoader::load(ids))
+    {
+        for (const auto &row : client.logs.all())
+        {
+            per_row_bytes += sizeof(std::string) + (row.message.size() > 15 ? row.message.size() + 1 : 0);
+        }
+    }
+    std::printf("per-row strings would need %zu KiB\n", per_row_bytes / 1024);
+
+    fs::remove_all(dir);
+    return 0;
+}
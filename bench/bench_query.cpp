@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "query/query.hpp"
+
+static std::map<std::string, ClientData> generate(int clients, int years)
+{
+    std::map<std::string, ClientData> result;
+    for (int c = 0; c < clients; c++)
+    {
+        ClientData client;
+        client.tag = c % 3 == 0 ? "ACME" : "OTHER";
+        client.hourly_rate = 50.0 + c;
+        for (int y = 0; y < years; y++)
+        {
+            for (int m = 1; m <= 12; m++)
+            {
+                for (int d = 1; d <= 28; d++)
+                    client.logs.set(Calendar::Date(2000 + y, m, d), 1.0 + (c + d) % 8, "Work");
+            }
+        }
+        result["client" + std::to_string(c)] = std::move(client);
+    }
+    return result;
+}
+
+static double run(const Query::Plan &plan, const std::map<std::string, ClientData> &clients,
+                  unsigned threads, int iterations, size_t &rows)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        rows = Query::run(plan, clients, threads).rows.size();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int clients = argc > 1 ? std::atoi(argv[1]) : 64;
+    int years = argc > 2 ? std::atoi(argv[2]) : 20;
+    int iterations = argc > 3 ? std::atoi(argv[3]) : 20;
+
+    auto data = generate(clients, years);
+    size_t total = 0;
+    for (const auto &[id, client] : data)
+        total += client.logs.size();
+    std::printf("%d clients x %d years, %zu rows\n", clients, years, total);
+
+    const char *queries[] = {
+        "sum(hours), sum(amount) where tag = ACME by month",
+        "avg(hours) where year = 2010 by weekday",
+        "count, sum(total) by year, client",
+    };
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (const char *text : queries)
+    {
+        Query::Plan plan = Query::parse(text);
+        size_t rows = 0;
+        double single = run(plan, data, 1, iterations, rows);
+        double parallel = run(plan, data, cores, iterations, rows);
+        std::printf("%-52s %6zu groups  1 thread %8.2f ms  %u threads %8.2f ms  (%.0f Mrows/s)\n",
+                    text, rows, single, cores, parallel, total / parallel / 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include "billing/constants.hpp"
+#include "report/work_log.hpp"
+
+namespace fs = std::filesystem;
+
+static const char *const kMessages[] = {
+    "Standup", "Code review", "Backend API development for the billing module",
+    "Frontend work on the customer dashboard & <reports>", "Bug fixing and regression testing",
+};
+
+// A year of weekday entries as one report.
+static WorkLogReportData year_of_entries()
+{
+    WorkLogReportData data;
+    data.client_name = "Bench Client";
+    data.month = "2025";
+    data.currency = "EUR";
+    data.hourly_rate = 100.0;
+    data.total_hours = 0.0;
+    for (Calendar::Date date(2025, 1, 1); date.year() == 2025; date = Calendar::add_days(date, 1))
+    {
+        if (Calendar::weekday(date) >= 5)
+            continue;
+        WorkLogEntry entry;
+        entry.date = Calendar::iso(date);
+        entry.hours = 8.0;
+        entry.message = kMessages[date.day() % 5];
+        data.total_hours += entry.hours;
+        data.entries.push_back(std::move(entry));
+    }
+    Billing::AmountBreakdown amounts = Billing::calculate_amounts(data.total_hours, data.hourly_rate);
+    data.subtotal = amounts.subtotal;
+    data.vat = amounts.vat;
+    data.total = amounts.total;
+    return data;
+}
+
+static void run(const char *label, ReportFormat format, const WorkLogReportData &data, int iterations,
+                const fs::path &dir)
+{
+    std::string path = (dir / (std::string("report.") + label)).string();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        std::unique_ptr<ReportRenderer> renderer = ReportRenderer::create(format);
+        WorkLogReport::render(data, *renderer);
+        renderer->save(path);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-5s %5zu rows  %8zu bytes  %8.3f ms/report\n", label, data.entries.size(),
+                static_cast<size_t>(fs::file_size(path)), elapsed.count() / iterations);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+
+    fs::path dir = fs::temp_directory_path() / "wlog_bench_render";
+    fs::create_directories(dir);
+
+    WorkLogReportData data = year_of_entries();
+    run("html", ReportFormat::Html, data, iterations, dir);
+    run("md", ReportFormat::Markdown, data, iterations, dir);
+    run("pdf", ReportFormat::Pdf, data, iterations, dir);
+
+    fs::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/search_index.hpp"
+
+namespace fs = std::filesystem;
+
+static const char *const kMessages[] = {
+    "Standup", "Code review", "Backend API development for the billing module",
+    "Frontend work on the customer dashboard", "Bug fixing and regression testing",
+};
+
+static void generate(int clients, int years)
+{
+    for (int c = 0; c < clients; c++)
+    {
+        ClientData client;
+        client.name = "Client " + std::to_string(c);
+        for (int y = 0; y < years; y++)
+        {
+            for (int m = 1; m <= 12; m++)
+            {
+                for (int d = 1; d <= 28; d++)
+                {
+                    char date[32];
+                    std::snprintf(date, sizeof(date), "%04d-%02d-%02d", 2020 + y, m, d);
+                    std::string message = kMessages[(d + m + c) % 5];
+                    message += " TICKET-" + std::to_string((c * 7919 + y * 336 + m * 28 + d) % 5000);
+                    client.logs.set(date, 8.0, message);
+                }
+            }
+        }
+        char id[32];
+        std::snprintf(id, sizeof(id), "client%02d", c);
+        ClientManager::save(id, client);
+    }
+}
+
+template <typename F>
+static double time_us(int iterations, F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        f(i);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int clients = argc > 1 ? std::atoi(argv[1]) : 20;
+    int years = argc > 2 ? std::atoi(argv[2]) : 5;
+    int iterations = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    fs::path dir = fs::temp_directory_path() / "wlog_bench_search";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    setenv("HOME", dir.c_str(), 1);
+    ConfigManager::ensure_directories();
+    DurableFile::set_policy(DurabilityPolicy::None);
+    ClientManager::set_layout(ClientLayout::Sharded);
+
+    generate(clients, years);
+
+    double rebuild = time_us(1, [](int) { SearchIndex::rebuild(); });
+    std::printf("%d clients x %d years, index %ju bytes, rebuild %.1f ms\n", clients, years,
+                static_cast<uintmax_t>(fs::file_size(SearchIndex::get_index_path())), rebuild / 1000.0);
+
+    size_t hits = 0;
+    double rare = time_us(iterations, [&](int i) {
+        hits += SearchIndex::search("ticket " + std::to_string(i * 37 % 5000)).size();
+    });
+    std::printf("%-24s %10.1f us/query  (%zu hits)\n", "rare term", rare, hits);
+
+    hits = 0;
+    double miss = time_us(iterations, [&](int) { hits += SearchIndex::search("nonexistent").size(); });
+    std::printf("%-24s %10.1f us/query  (%zu hits)\n", "no match", miss, hits);
+
+    hits = 0;
+    double range = time_us(iterations, [&](int i) {
+        hits += SearchIndex::search("billing ticket " + std::to_string(i * 37 % 5000), "",
+                                    Calendar::Date(2021, 1, 1), Calendar::Date(2021, 12, 31)).size();
+    });
+    std::printf("%-24s %10.1f us/query  (%zu hits)\n", "two terms, one year", range, hits);
+
+    fs::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace Calendar
+{
+    // A calendar date packed as yyyymmdd. Month keys use day 0 (yyyymm00),
+    // so packed values sort chronologically and a month spans [m, m + 99].
+    struct Date
+    {
+        uint32_t value = 0;
+
+        constexpr Date() = default;
+        constexpr explicit Date(uint32_t packed) : value(packed) {}
+        constexpr Date(int year, int month, int day)
+            : value(static_cast<uint32_t>(year * 10000 + month * 100 + day)) {}
+
+        constexpr int year() const { return static_cast<int>(value / 10000); }
+        constexpr int month() const { return static_cast<int>(value / 100 % 100); }
+        constexpr int day() const { return static_cast<int>(value % 100); }
+        constexpr bool valid() const { return value != 0; }
+        constexpr Date month_start() const { return Date(value / 100 * 100); }
+        constexpr Date month_end() const { return Date(value / 100 * 100 + 99); }
+
+        constexpr bool operator==(Date other) const { return value == other.value; }
+        constexpr bool operator!=(Date other) const { return value != other.value; }
+        constexpr bool operator<(Date other) const { return value < other.value; }
+        constexpr bool operator<=(Date other) const { return value <= other.value; }
+        constexpr bool operator>(Date other) const { return value > other.value; }
+        constexpr bool operator>=(Date other) const { return value >= other.value; }
+    };
+
+    constexpr bool is_leap_year(int year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    constexpr int days_in_month(int year, int month)
+    {
+        constexpr int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && is_leap_year(year) ? 29 : days[month - 1];
+    }
+
+    constexpr bool is_valid(int year, int month, int day)
+    {
+        return year >= 1 && year <= 9999 && month >= 1 && month <= 12 &&
+               day >= 1 && day <= days_in_month(year, month);
+    }
+
+    namespace detail
+    {
+        constexpr bool parse_digits(std::string_view s, size_t pos, size_t count, int &value)
+        {
+            value = 0;
+            for (size_t i = pos; i < pos + count; i++)
+            {
+                if (s[i] < '0' || s[i] > '9')
+                    return false;
+                value = value * 10 + (s[i] - '0');
+            }
+            return true;
+        }
+    }
+
+    // "YYYY-MM-DD"; returns an invalid Date unless it names a real day.
+    constexpr Date parse_date(std::string_view s)
+    {
+        int year = 0, month = 0, day = 0;
+        if (s.size() != 10 || s[4] != '-' || s[7] != '-' ||
+            !detail::parse_digits(s, 0, 4, year) || !detail::parse_digits(s, 5, 2, month) ||
+            !detail::parse_digits(s, 8, 2, day) || !is_valid(year, month, day))
+        {
+            return Date();
+        }
+        return Date(year, month, day);
+    }
+
+    // Like parse_date, but only checks the shape (day 1-31). Stored logs from
+    // before calendar validation may name days such as 02-30.
+    constexpr Date parse_stored_date(std::string_view s)
+    {
+        int year = 0, month = 0, day = 0;
+        if (s.size() != 10 || s[4] != '-' || s[7] != '-' ||
+            !detail::parse_digits(s, 0, 4, year) || !detail::parse_digits(s, 5, 2, month) ||
+            !detail::parse_digits(s, 8, 2, day) || !is_valid(year, month, 1) || day < 1 || day > 31)
+        {
+            return Date();
+        }
+        return Date(year, month, day);
+    }
+
+    // "YYYY-MM" to the month key yyyymm00.
+    constexpr Date parse_month(std::string_view s)
+    {
+        int year = 0, month = 0;
+        if (s.size() != 7 || s[4] != '-' ||
+            !detail::parse_digits(s, 0, 4, year) || !detail::parse_digits(s, 5, 2, month) ||
+            !is_valid(year, month, 1))
+        {
+            return Date();
+        }
+        return Date(year, month, 0);
+    }
+
+    // Days are clamped to the target month; month keys stay month keys.
+    constexpr Date add_months(Date date, int months)
+    {
+        int index = date.year() * 12 + date.month() - 1 + months;
+        int year = index / 12;
+        int month = index % 12 + 1;
+        int day = date.day();
+        if (day > days_in_month(year, month))
+            day = days_in_month(year, month);
+        return Date(year, month, day);
+    }
+
+    // Days since 1970-01-01 (Howard Hinnant's days_from_civil).
+    constexpr int64_t to_days(Date date)
+    {
+        int64_t y = date.year() - (date.month() <= 2 ? 1 : 0);
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        int64_t yoe = y - era * 400;
+        int64_t mp = (date.month() + 9) % 12;
+        int64_t doy = (153 * mp + 2) / 5 + date.day() - 1;
+        int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    constexpr Date from_days(int64_t days)
+    {
+        days += 719468;
+        int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        int64_t doe = days - era * 146097;
+        int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        int64_t mp = (5 * doy + 2) / 153;
+        int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        int year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+        return Date(year, month, day);
+    }
+
+    constexpr Date add_days(Date date, int days)
+    {
+        return from_days(to_days(date) + days);
+    }
+
+    // Monday = 0 ... Sunday = 6.
+    constexpr int weekday(Date date)
+    {
+        int64_t days = to_days(date);
+        return static_cast<int>(((days % 7) + 7 + 3) % 7);
+    }
+
+    constexpr Date due_date(Date issued, int payment_term_days)
+    {
+        return add_days(issued, payment_term_days);
+    }
+
+    inline Date today()
+    {
+        std::time_t now = std::time(nullptr);
+        std::tm tm = {};
+        localtime_r(&now, &tm);
+        return Date(1900 + tm.tm_year, tm.tm_mon + 1, tm.tm_mday);
+    }
+
+    // Fixed-capacity formatted text; formatting never allocates.
+    class Text
+    {
+    public:
+        constexpr void push(char c)
+        {
+            if (size_ < sizeof(data_) - 1)
+            {
+                data_[size_++] = c;
+                data_[size_] = '\0';
+            }
+        }
+
+        constexpr void append(std::string_view s)
+        {
+            for (char c : s)
+                push(c);
+        }
+
+        constexpr void append_number(int value, int width)
+        {
+            char digits[8] = {};
+            int count = 0;
+            do
+            {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value > 0 && count < 8);
+            for (int i = count; i < width; i++)
+                push('0');
+            while (count > 0)
+                push(digits[--count]);
+        }
+
+        const char *c_str() const { return data_; }
+        constexpr std::string_view view() const { return {data_, size_}; }
+        constexpr size_t size() const { return size_; }
+        std::string str() const { return std::string(data_, size_); }
+        constexpr operator std::string_view() const { return view(); }
+
+    private:
+        char data_[24] = {};
+        size_t size_ = 0;
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, const Text &text)
+    {
+        return os << text.view();
+    }
+
+    namespace detail
+    {
+        constexpr std::string_view month_names[] = {
+            "January", "February", "March", "April", "May", "June",
+            "July", "August", "September", "October", "November", "December"};
+    }
+
+    // 2026-01-15
+    constexpr Text iso(Date date)
+    {
+        Text text;
+        text.append_number(date.year(), 4);
+        text.push('-');
+        text.append_number(date.month(), 2);
+        text.push('-');
+        text.append_number(date.day(), 2);
+        return text;
+    }
+
+    // 2026-01
+    constexpr Text month_key(Date date)
+    {
+        Text text;
+        text.append_number(date.year(), 4);
+        text.push('-');
+        text.append_number(date.month(), 2);
+        return text;
+    }
+
+    // Jan 15
+    constexpr Text short_date(Date date)
+    {
+        Text text;
+        text.append(detail::month_names[date.month() - 1].substr(0, 3));
+        text.push(' ');
+        text.append_number(date.day(), 2);
+        return text;
+    }
+
+    // Jan 15, 2026
+    constexpr Text long_date(Date date)
+    {
+        Text text = short_date(date);
+        text.append(", ");
+        text.append_number(date.year(), 4);
+        return text;
+    }
+
+    // January 2026
+    constexpr Text month_title(Date date)
+    {
+        Text text;
+        text.append(detail::month_names[date.month() - 1]);
+        text.push(' ');
+        text.append_number(date.year(), 4);
+        return text;
+    }
+}
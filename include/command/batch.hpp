@@ -0,0 +1,16 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "command/log.hpp"
+
+// Parses one batch line with the same grammar as the command line.
+using BatchParser = std::function<bool(const std::string &line, WlogOptions &opts, std::string &error)>;
+
+// Runs newline-delimited commands from in against one session and writes one
+// JSON object per command to out. Clients stay loaded between commands and
+// storage is flushed every checkpoint_every commands (0: only at the end).
+// Returns 0 when every command succeeded, 1 otherwise.
+int run_batch(std::istream &in, std::ostream &out, const BatchParser &parse, unsigned checkpoint_every = 0);
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include "calendar/date.hpp"
+#include "report/renderer.hpp"
 
 struct WlogOptions
 {
@@ -9,16 +12,60 @@ struct WlogOptions
     std::string message;
     std::string day;
     std::string month;
+    std::string from;
+    std::string to;
+    bool week = false;
+    unsigned last = 0;
     bool setup = false;
     bool invoice = false;
     bool report = false;
+    std::string format;
     bool show = false;
     bool today_only = false;
+    bool all = false;
+    bool list_clients = false;
+    bool archive = false;
+    bool batch = false;
+    unsigned checkpoint = 0;
+    std::string export_format;
+    std::string output;
+    std::string search;
+    bool reindex = false;
+    std::string query;
+    bool watch = false;
+    std::vector<std::string> merge;
+    std::string sync;
+    std::string backup;
+    std::string restore;
+    std::string snapshot;
+    std::string snapshots;
 };
 
+// Resolves --from/--to, --week or --last into an inclusive date range.
+// Returns false when none is set; throws on invalid input.
+bool resolve_show_range(const WlogOptions &opts, Calendar::Date today,
+                        Calendar::Date &from, Calendar::Date &to);
+
+// --format, or PDF when unset.
+ReportFormat report_format(const WlogOptions &opts);
+
 void run_setup();
 void run_client_setup(const std::string &client);
+void run_bulk_setup(const WlogOptions &opts);
 void run_log(const WlogOptions &opts);
 void run_show(const WlogOptions &opts);
+void run_show_all(const WlogOptions &opts);
+void run_list_clients();
+void run_archive(const WlogOptions &opts);
+void run_export(const WlogOptions &opts);
+void run_search(const WlogOptions &opts);
+void run_reindex();
+void run_query(const WlogOptions &opts);
+void run_merge(const WlogOptions &opts);
+void run_sync(const WlogOptions &opts);
+void run_backup(const WlogOptions &opts);
+void run_restore(const WlogOptions &opts);
+void run_list_snapshots(const WlogOptions &opts);
 void run_invoice(const WlogOptions &opts);
+void run_invoice_all(const WlogOptions &opts);
 void run_report(const WlogOptions &opts);
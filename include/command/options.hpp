@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include "command/log.hpp"
+
+namespace CLI
+{
+    class App;
+}
+
+// The command line grammar, shared by main() and --batch lines.
+void add_options(CLI::App &app, WlogOptions &opts);
+
+// A bare month number (e.g. "3") becomes that month of this year; anything
+// else is returned as given.
+std::string normalize_month(const std::string &month);
+
+// Parses one --batch line with the same options as the command line.
+bool parse_batch_line(const std::string &line, WlogOptions &opts, std::string &error);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include "calendar/date.hpp"
+
+// Today's and this month's hours per client, kept up to date one client at a
+// time: a refresh reloads only that client's current month and adjusts the
+// totals by the difference.
+class WatchSummary
+{
+public:
+    explicit WatchSummary(Calendar::Date today);
+
+    // Reloads every client; also used when the day rolls over.
+    void refresh_all(Calendar::Date today);
+    void refresh(const std::string &client_id);
+
+    Calendar::Date day() const { return today_; }
+    double today_total() const { return today_total_; }
+    double month_total() const { return month_total_; }
+    size_t client_count() const { return clients_.size(); }
+
+    void render(std::ostream &out) const;
+
+private:
+    struct Entry
+    {
+        std::string name;
+        double today = 0.0;
+        double month = 0.0;
+    };
+
+    void remove(const std::string &client_id);
+
+    Calendar::Date today_;
+    std::map<std::string, Entry> clients_;
+    double today_total_ = 0.0;
+    double month_total_ = 0.0;
+};
+
+// Redraws the summary whenever a client is saved. Runs until interrupted.
+void run_watch();
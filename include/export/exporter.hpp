@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class ExportFormat
+{
+    Csv,
+    Jsonl,
+    Columnar
+};
+
+// Columnar layout (little-endian), one block per client:
+//
+//   "WLOGCOL1"
+//   block*    u32 id length, id bytes, u32 rows, u32 messages,
+//             u32 dates[rows] (yyyymmdd), f64 hours[rows],
+//             u32 message[rows] (index into the block's dictionary),
+//             messages x (u32 length, bytes)
+//   u32 0     end marker
+class Exporter
+{
+public:
+    static ExportFormat parse_format(const std::string &name);
+
+    // Writes the full history (live and archived months) of the given clients,
+    // or of every client when client_ids is empty. Clients are loaded and
+    // written one at a time, so memory stays bounded by the largest client.
+    // Returns the number of rows written.
+    static size_t write(std::ostream &out, ExportFormat format,
+                        const std::vector<std::string> &client_ids = {});
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <istream>
+#include <nlohmann/json.hpp>
+
+struct BulkSetupResult
+{
+    bool config_saved = false;
+    size_t created = 0;
+    size_t updated = 0;
+    size_t unchanged = 0;
+};
+
+// Non-interactive setup from a manifest:
+//
+//   { "company": { "name": ..., "tag": ..., ... },
+//     "clients": { "acme": { "name": ..., "hourly_rate": 95, ... }, ... } }
+//
+// Field names are those of the config and client files. Fields left out keep
+// their current value, or the default for new records. The whole manifest is
+// checked with the same rules as the interactive flows before anything is
+// written; every problem is reported in one error. Changed records are then
+// written once, in a single batch.
+class BulkSetup
+{
+public:
+    static BulkSetupResult apply(const nlohmann::json &manifest);
+    static BulkSetupResult apply(std::istream &in);
+};
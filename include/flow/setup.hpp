@@ -1,7 +1,12 @@
 #pragma once
 
+#include <string>
+
 class SetupFlow
 {
 public:
     static void start();
-};
\ No newline at end of file
+
+    // Copies a logo into the logos directory and returns its new path.
+    static std::string install_logo(const std::string &path);
+};
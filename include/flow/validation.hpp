@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "storage/client.hpp"
+#include "storage/config.hpp"
+
+// Field rules shared by the interactive setup flows and bulk setup. Each
+// check returns an empty string when the value is acceptable and the message
+// to show otherwise.
+namespace Validation
+{
+    std::string required(const std::string &value);
+    std::string positive_number(const std::string &text, double &value);
+    std::string positive_integer(const std::string &text, int &value);
+    std::string client_id(const std::string &id);
+    std::string logo_path(const std::string &path);
+
+    // Every problem with a whole record, each prefixed with its field name.
+    std::vector<std::string> company(const CompanyConfig &company);
+    std::vector<std::string> client(const ClientData &client);
+}
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <hpdf.h>
+#include "calendar/date.hpp"
+#include "invoice/template.hpp"
 #include "storage/config.hpp"
 #include "storage/client.hpp"
 
@@ -32,46 +36,36 @@ struct InvoiceData
     double total;
 };
 
+// Draws one invoice: the company layer is replayed from a template, then the
+// invoice's own fields are drawn on top.
 class PDFBuilder
 {
 public:
-    PDFBuilder(const InvoiceData &data);
+    PDFBuilder(const InvoiceData &data, const InvoiceTemplate &layout);
     ~PDFBuilder();
 
     void build();
     void save(const std::string &output_path);
 
 private:
-    void draw_header();
-    void draw_logo();
-    void draw_invoice_title();
-    void draw_company_info();
-    void draw_date_info();
-    void draw_balance_due_box();
+    void draw_invoice_number();
+    void draw_dates();
+    void draw_balance_due();
     void draw_billed_to();
-    float draw_table();
-    void draw_table_header(float y);
-    void draw_table_row(float y);
-    float draw_totals(float y);
-    void draw_footer(float y);
+    void draw_amounts();
+    void draw_terms();
 
     void text(float x, float y, const std::string &s);
     void set_font(bool bold, float size);
     void set_color(float gray);
-    void set_color(float r, float g, float b);
-    void draw_rounded_rect(float x, float y, float w, float h, float r);
-    std::string format_currency(double amount);
-    std::string format_date(const std::string &date);
+    static Calendar::Text format_date(std::string_view date);
 
     const InvoiceData &data_;
+    const InvoiceTemplate &layout_;
     HPDF_Doc pdf_;
     HPDF_Page page_;
     HPDF_Font font_;
     HPDF_Font font_bold_;
-
-    static constexpr float PAGE_WIDTH = 595.0f;
-    static constexpr float PAGE_HEIGHT = 842.0f;
-    static constexpr float MARGIN = 50.0f;
 };
 
 class InvoiceGenerator
@@ -79,6 +73,16 @@ class InvoiceGenerator
 public:
     static std::string generate(const std::string &client_id, const std::string &month = "");
 
+    // Builds the invoice for hours already totalled by the caller.
+    static InvoiceData prepare_data(const AppConfig &config, const ClientData &client,
+                                    const std::string &month_key, double total_hours);
+    // Reuses the company template of the previous invoice when it still applies.
+    static std::string save(const InvoiceData &data);
+
+    // Invoices every client with hours in month (the previous month when
+    // empty); returns the files written, in client order.
+    static std::vector<std::string> generate_all(const std::string &month = "");
+
 private:
     static InvoiceData prepare_data(const std::string &client_id, const std::string &month);
 };
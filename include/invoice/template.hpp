@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <hpdf.h>
+
+struct InvoiceData;
+
+namespace InvoiceLayout
+{
+    constexpr float PAGE_WIDTH = 595.0f;
+    constexpr float PAGE_HEIGHT = 842.0f;
+    constexpr float MARGIN = 50.0f;
+
+    constexpr float LABEL_X = 360.0f;
+    constexpr float QUANTITY_X = 280.0f;
+    constexpr float RATE_X = 380.0f;
+    constexpr float VALUE_X = 480.0f;
+
+    constexpr float TITLE_Y = PAGE_HEIGHT - MARGIN;
+    constexpr float INFO_Y = PAGE_HEIGHT - MARGIN - 100;
+    constexpr float BALANCE_Y = INFO_Y - 61;
+    constexpr float BILLED_TO_Y = PAGE_HEIGHT - MARGIN - 169;
+    constexpr float TABLE_Y = PAGE_HEIGHT - MARGIN - 252;
+    constexpr float ROW_Y = TABLE_Y - 28;
+    constexpr float TOTALS_Y = TABLE_Y - 73;
+    constexpr float FOOTER_Y = TOTALS_Y - 76;
+    constexpr float LINE = 18.0f;
+}
+
+// Everything on an invoice that only depends on the company: labels, boxes,
+// company details and the logo. It is recorded once as a list of drawing
+// commands and replayed onto each invoice's page, so an invoice only draws
+// its own fields on top.
+class InvoiceTemplate
+{
+public:
+    // Takes the company fields of data.
+    explicit InvoiceTemplate(const InvoiceData &data);
+
+    // Whether data has the company details this template was made from.
+    bool matches(const InvoiceData &data) const;
+
+    void replay(HPDF_Doc pdf, HPDF_Page page, HPDF_Font font, HPDF_Font font_bold) const;
+
+    std::string format_currency(double amount) const;
+
+private:
+    struct Command
+    {
+        enum class Kind
+        {
+            Font,
+            Fill,
+            Text,
+            RoundedRect
+        };
+
+        Kind kind = Kind::Text;
+        bool bold = false;
+        float size = 0;
+        float red = 0, green = 0, blue = 0;
+        float x = 0, y = 0, width = 0, height = 0, radius = 0;
+        std::string text;
+    };
+
+    void set_font(bool bold, float size);
+    void set_color(float red, float green, float blue);
+    void set_color(float gray) { set_color(gray, gray, gray); }
+    void text(float x, float y, std::string text);
+    void rounded_rect(float x, float y, float width, float height, float radius);
+    void load_logo(const std::string &path);
+
+    std::vector<Command> commands_;
+    std::string company_;
+    std::string currency_prefix_;
+    std::string logo_;
+
+    // Drawing state at the end of the list, so redundant changes are skipped.
+    bool bold_ = false;
+    float size_ = 0;
+    float red_ = 0, green_ = 0, blue_ = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "calendar/date.hpp"
+#include "storage/client.hpp"
+#include "report/renderer.hpp"
+
+// Another user's data directory (the equivalent of ~/.wlog) and who they are.
+struct MergeSource
+{
+    std::string author;
+    std::string dir;
+};
+
+struct MergedEntry
+{
+    Calendar::Date date;
+    double hours = 0.0;
+    const std::string *author = nullptr;
+    std::string_view message;
+};
+
+using MergeSink = std::function<void(const MergedEntry &entry)>;
+
+// Consolidates one client's month across several data roots. Each root's
+// month is already sorted by date, so the roots are k-way merged into date
+// order (same-day entries in root order) and handed to a sink one at a time.
+// Only the requested month of one client is read from each root.
+class TeamMerge
+{
+public:
+    // "name=dir", or just dir: the author is then the directory's owner
+    // (/home/alice/.wlog -> alice) or, failing that, its name.
+    static MergeSource parse_source(const std::string &spec);
+
+    // Returns the client's details (without logs) from the first root that
+    // has the client. Throws when none does.
+    static ClientData merge_month(const std::vector<MergeSource> &roots, const std::string &client_id,
+                                  const std::string &month_key, const MergeSink &sink);
+
+    // Consolidated work log report and invoice, written like their
+    // single-user counterparts. Company details come from the current config.
+    static std::string generate_report(const std::vector<MergeSource> &roots, const std::string &client_id,
+                                       const std::string &month = "", ReportFormat format = ReportFormat::Pdf);
+    static std::string generate_invoice(const std::vector<MergeSource> &roots, const std::string &client_id,
+                                        const std::string &month = "");
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "billing/constants.hpp"
+#include "calendar/date.hpp"
+#include "storage/client.hpp"
+
+namespace Pipeline
+{
+    struct Summary
+    {
+        size_t entries = 0;
+        double hours = 0.0;
+        Billing::AmountBreakdown amounts = {0.0, 0.0, 0.0};
+    };
+
+    // Where a pipeline's output goes. begin() gets the client before any
+    // row, row() each kept row in date order, finish() the totals.
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+
+        // Sinks that only need the totals are never handed rows, and the
+        // totals are then taken straight from the hours column.
+        virtual bool needs_rows() const { return true; }
+
+        virtual void begin(const ClientData &client) {}
+        virtual void row(const WorkLogRow &row) {}
+        virtual void finish(const Summary &summary) {}
+    };
+
+    using Filter = std::function<bool(const WorkLogRow &row)>;
+
+    // source -> filters -> aggregate -> sink for one client's logs between
+    // two dates (inclusive). Nothing is loaded until run(), and then only the
+    // storage covering the range.
+    class Source
+    {
+    public:
+        Source(std::string client_id, Calendar::Date from, Calendar::Date to);
+
+        static Source month(const std::string &client_id, const std::string &month_key);
+
+        Source &filter(Filter keep);
+
+        Summary run(Sink &sink);
+        Summary totals();
+
+        // The client as loaded by the last run.
+        const ClientData &client() const { return client_; }
+
+    private:
+        std::string client_id_;
+        Calendar::Date from_;
+        Calendar::Date to_;
+        std::vector<Filter> filters_;
+        ClientData client_;
+    };
+}
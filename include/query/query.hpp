@@ -0,0 +1,105 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "storage/client.hpp"
+
+// wlog query grammar:
+//
+//   query      := aggregate { "," aggregate } { "where" filter { "and" filter } | "by" key [ "," key ] }
+//   aggregate  := "count" | ( "sum" | "avg" | "min" | "max" ) "(" column ")"
+//   column     := hours | amount | vat | total
+//   filter     := field op value        op := = != < <= > >=
+//   field      := client | tag | date | year | month | weekday | hours
+//   key        := client | tag | year | month | weekday | date
+//
+// e.g.  sum(hours), sum(amount) where tag = ACME by month
+//       avg(hours) where year = 2025 by weekday
+//
+// client and tag only support = and !=. Dates are YYYY-MM-DD, months YYYY-MM
+// and weekdays mon .. sun. Money columns use the client's hourly rate.
+namespace Query
+{
+    enum class Column
+    {
+        Hours,
+        Amount,
+        Vat,
+        Total
+    };
+
+    enum class Function
+    {
+        Count,
+        Sum,
+        Avg,
+        Min,
+        Max
+    };
+
+    enum class Field
+    {
+        Client,
+        Tag,
+        Date,
+        Year,
+        Month,
+        Weekday,
+        Hours
+    };
+
+    enum class Op
+    {
+        Eq,
+        Ne,
+        Lt,
+        Le,
+        Gt,
+        Ge
+    };
+
+    struct Aggregate
+    {
+        Function function = Function::Count;
+        Column column = Column::Hours;
+    };
+
+    struct Filter
+    {
+        Field field = Field::Client;
+        Op op = Op::Eq;
+        std::string text;
+        double number = 0.0;
+    };
+
+    struct Plan
+    {
+        std::vector<Aggregate> aggregates;
+        std::vector<Filter> filters;
+        std::vector<Field> keys;
+    };
+
+    struct Row
+    {
+        std::vector<std::string> keys;
+        std::vector<double> values;
+    };
+
+    struct Result
+    {
+        std::vector<std::string> key_names;
+        std::vector<std::string> value_names;
+        std::vector<Row> rows;
+    };
+
+    // Throws std::runtime_error describing the first problem.
+    Plan parse(const std::string &text);
+
+    // Clients are scanned in parallel, one client per task. Rows come out
+    // ordered by key.
+    Result run(const Plan &plan, const std::map<std::string, ClientData> &clients, unsigned threads = 0);
+
+    // Loads every client, archived months included, and runs text over them.
+    Result run(const std::string &text, unsigned threads = 0);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include "calendar/date.hpp"
+
+struct WorkLogReportData;
+
+enum class ReportFormat
+{
+    Pdf,
+    Html,
+    Markdown
+};
+
+// Output backend for a work log report. begin() gets the report's header
+// fields (its entries may be empty), row() each entry in date order and
+// finish() the totals; save() then writes the result.
+class ReportRenderer
+{
+public:
+    virtual ~ReportRenderer() = default;
+
+    static std::unique_ptr<ReportRenderer> create(ReportFormat format);
+
+    virtual void begin(const WorkLogReportData &data) = 0;
+    virtual void row(Calendar::Date date, double hours, std::string_view message) = 0;
+    virtual void finish(const WorkLogReportData &data) = 0;
+    virtual void save(const std::string &path) const = 0;
+};
+
+// Renders into a string as rows arrive, without libharu.
+class TextReportRenderer : public ReportRenderer
+{
+public:
+    const std::string &text() const { return text_; }
+    void save(const std::string &path) const override;
+
+protected:
+    void append_number(double value, int decimals);
+    void append_amount(const WorkLogReportData &data, double amount);
+
+    std::string text_;
+};
+
+// A self-contained page (inline styles, nothing external), so it can be
+// opened directly or served as is.
+class HtmlReportRenderer : public TextReportRenderer
+{
+public:
+    void begin(const WorkLogReportData &data) override;
+    void row(Calendar::Date date, double hours, std::string_view message) override;
+    void finish(const WorkLogReportData &data) override;
+
+private:
+    void append_escaped(std::string_view text);
+};
+
+class MarkdownReportRenderer : public TextReportRenderer
+{
+public:
+    void begin(const WorkLogReportData &data) override;
+    void row(Calendar::Date date, double hours, std::string_view message) override;
+    void finish(const WorkLogReportData &data) override;
+
+private:
+    void append_escaped(std::string_view text);
+};
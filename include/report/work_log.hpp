@@ -1,16 +1,21 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <hpdf.h>
+#include "calendar/date.hpp"
 #include "storage/config.hpp"
 #include "storage/client.hpp"
+#include "pipeline/pipeline.hpp"
+#include "report/renderer.hpp"
 
 struct WorkLogEntry
 {
-    std::string date;
+    std::pmr::string date;
     double hours;
-    std::string message;
+    std::pmr::string message;
 };
 
 struct WorkLogReportData
@@ -23,7 +28,38 @@ struct WorkLogReportData
     double subtotal;
     double vat;
     double total;
-    std::vector<WorkLogEntry> entries;
+    std::pmr::vector<WorkLogEntry> entries;
+};
+
+// Collects a pipeline's rows and totals into report data.
+class WorkLogReportSink : public Pipeline::Sink
+{
+public:
+    explicit WorkLogReportSink(WorkLogReportData &data) : data_(data) {}
+
+    void begin(const ClientData &client) override;
+    void row(const WorkLogRow &row) override;
+    void finish(const Pipeline::Summary &summary) override;
+
+private:
+    WorkLogReportData &data_;
+};
+
+// Hands a pipeline's rows straight to a renderer. data supplies the month
+// and currency and receives the client details and totals. Throws when the
+// month has no rows.
+class ReportRenderSink : public Pipeline::Sink
+{
+public:
+    ReportRenderSink(WorkLogReportData &data, ReportRenderer &renderer) : data_(data), renderer_(renderer) {}
+
+    void begin(const ClientData &client) override;
+    void row(const WorkLogRow &row) override;
+    void finish(const Pipeline::Summary &summary) override;
+
+private:
+    WorkLogReportData &data_;
+    ReportRenderer &renderer_;
 };
 
 class WorkLogPDFBuilder
@@ -43,8 +79,8 @@ private:
 
     void draw_rounded_rect(float x, float y, float width, float height, float radius);
     std::string format_currency(double amount);
-    static std::string format_date(const std::string &date);
-    std::vector<std::string> wrap_text(const std::string &text, float max_width);
+    static Calendar::Text format_date(std::string_view date);
+    std::vector<std::string> wrap_text(std::string_view text, float max_width);
     float add_new_page();
 
     const WorkLogReportData &data_;
@@ -58,11 +94,33 @@ private:
     static constexpr float MARGIN = 50.0f;
 };
 
-class WorkLogReport
+// Collects the rows, since page layout needs them all, and draws the PDF on save.
+class PdfReportRenderer : public ReportRenderer
 {
 public:
-    static std::string generate(const std::string &client_id, const std::string &month = "");
+    void begin(const WorkLogReportData &data) override;
+    void row(Calendar::Date date, double hours, std::string_view message) override;
+    void finish(const WorkLogReportData &data) override;
+    void save(const std::string &path) const override;
 
 private:
+    WorkLogReportData data_;
+};
+
+class WorkLogReport
+{
+public:
+    // pdf, html or md.
+    static ReportFormat parse_format(const std::string &name);
+    static std::string output_path(const std::string &client_id, const std::string &month, ReportFormat format);
+
+    static std::string generate(const std::string &client_id, const std::string &month = "",
+                                ReportFormat format = ReportFormat::Pdf);
     static WorkLogReportData prepare_data(const std::string &client_id, const std::string &month);
+
+    static void render(const WorkLogReportData &data, ReportRenderer &renderer);
+
+    // Writes worklog-<client_id>-<month>.<pdf|html|md>.
+    static std::string save(const std::string &client_id, const WorkLogReportData &data,
+                            ReportFormat format = ReportFormat::Pdf);
 };
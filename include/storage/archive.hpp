@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include "storage/client.hpp"
+
+class ArchiveManager
+{
+public:
+    static std::string get_archive_dir();
+    static std::string get_archive_path(const std::string &client_id);
+
+    static WorkLogTable load(const std::string &client_id);
+
+    // Moves months before cutoff_month (YYYY-MM) out of the live client data
+    // into the compressed archive. Returns the number of months moved.
+    static int archive_client(const std::string &client_id, const std::string &cutoff_month);
+
+    static std::string get_cutoff_month(int horizon_months);
+};
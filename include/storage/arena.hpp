@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+
+// Makes a monotonic buffer the default std::pmr resource while in scope, so
+// work log tables and report data allocate by bumping a pointer and are
+// released together when the arena closes. Data must not outlive the arena.
+class CommandArena
+{
+public:
+    explicit CommandArena(size_t initial_size = 64 * 1024);
+    ~CommandArena();
+
+    CommandArena(const CommandArena &) = delete;
+    CommandArena &operator=(const CommandArena &) = delete;
+
+    size_t bytes_allocated() const;
+
+private:
+    // Shared by the thread buffers for their chunks, which grow geometrically,
+    // so its lock is taken rarely.
+    class ChunkResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit ChunkResource(size_t initial_size) : buffer_(initial_size) {}
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        std::pmr::monotonic_buffer_resource buffer_;
+        std::mutex mutex_;
+    };
+
+    struct ThreadBuffer
+    {
+        explicit ThreadBuffer(std::pmr::memory_resource *chunks) : buffer(chunks) {}
+
+        std::pmr::monotonic_buffer_resource buffer;
+        std::atomic<size_t> bytes{0};
+    };
+
+    // BatchLoader parses on worker threads, so every thread bumps its own
+    // buffer and allocation doesn't contend.
+    class ThreadedResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit ThreadedResource(size_t initial_size);
+
+        size_t bytes_allocated() const;
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        ThreadBuffer &local();
+
+        uint64_t id_;
+        ChunkResource chunks_;
+        mutable std::mutex mutex_;
+        std::map<std::thread::id, std::unique_ptr<ThreadBuffer>> threads_;
+    };
+
+    ThreadedResource resource_;
+    std::pmr::memory_resource *previous_;
+};
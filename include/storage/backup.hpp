@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct BackupResult
+{
+    std::string snapshot;
+    size_t files = 0;
+    size_t files_read = 0;
+    size_t chunks_written = 0;
+    size_t bytes_written = 0;
+};
+
+// Deduplicating snapshots of the data directory. Files are cut into
+// content-defined chunks, so an edit only produces new chunks around the
+// change, and every chunk is stored once, compressed, under
+// chunks/<xx>/<sha256>. A snapshot (snapshots/<name>.json) lists each
+// file's size, modification time and chunks; files whose size and time
+// match the previous snapshot reuse its chunk list without being read.
+// The search index is derived data and is left out.
+class BackupManager
+{
+public:
+    static constexpr size_t MIN_CHUNK = 2 * 1024;
+    static constexpr size_t AVG_CHUNK = 8 * 1024;
+    static constexpr size_t MAX_CHUNK = 64 * 1024;
+
+    // Chunk boundaries: offsets where each chunk ends.
+    static std::vector<size_t> chunk(std::string_view data);
+
+    static BackupResult backup(const std::string &dest);
+
+    // Snapshot names, oldest first.
+    static std::vector<std::string> list(const std::string &dest);
+
+    // Makes the data directory match the snapshot (the latest when empty):
+    // files are rewritten and files it does not contain are removed.
+    static std::string restore(const std::string &dest, const std::string &snapshot = "");
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include "storage/client.hpp"
+
+class BatchLoader
+{
+public:
+    static std::vector<std::string> list_client_ids();
+
+    // Reads all single-file clients up front (io_uring where available,
+    // otherwise on the worker threads) and parses them in parallel. Sharded
+    // clients are assembled on the workers. Missing clients are skipped.
+    // All returned clients share one message pool.
+    static std::map<std::string, ClientData> load(const std::vector<std::string> &client_ids,
+                                                  unsigned threads = 0);
+    static std::map<std::string, ClientData> load_all(unsigned threads = 0);
+
+    static bool io_uring_available();
+};
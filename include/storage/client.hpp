@@ -2,15 +2,10 @@
 
 #include <string>
 #include <map>
+#include <set>
 #include <nlohmann/json.hpp>
-
-struct WorkLog
-{
-    double hours;
-    std::string message;
-
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(WorkLog, hours, message)
-};
+#include "storage/config.hpp"
+#include "storage/work_log_table.hpp"
 
 struct ClientData
 {
@@ -21,23 +16,51 @@ struct ClientData
     int payment_term_days = 14;
     std::string tag;
     int next_invoice_number = 1;
-    std::map<std::string, std::map<std::string, WorkLog>> logs;
+    WorkLogTable logs;
+    std::set<std::string> archived_months;
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
         ClientData,
         name, address_line1, address_line2, hourly_rate,
-        payment_term_days, tag, next_invoice_number, logs
+        payment_term_days, tag, next_invoice_number, logs, archived_months
     )
 };
 
 class ClientManager
 {
 public:
+    static void set_layout(ClientLayout layout);
+    static ClientLayout get_layout();
+
     static std::string get_client_path(const std::string &client_id);
+    static std::string get_client_dir(const std::string &client_id);
+    static std::string get_meta_path(const std::string &client_id);
+    static std::string get_shard_path(const std::string &client_id, const std::string &year);
+
     static bool client_exists(const std::string &client_id);
+    static bool is_sharded(const std::string &client_id);
+
     static ClientData load(const std::string &client_id);
+    // Reads only what month_key needs: one shard for sharded clients, plus the
+    // archive when that month was archived. Use for read-only access.
+    static ClientData load(const std::string &client_id, const std::string &month_key);
+    // Same for an inclusive date range: only shards for the years in range and
+    // the archive only if an archived month falls inside it.
+    static ClientData load(const std::string &client_id, Calendar::Date from, Calendar::Date to);
+    // Adds archived entries in [from, to] to data when an archived month falls
+    // inside it; live entries take precedence.
+    static void merge_archive(const std::string &client_id, ClientData &data, Calendar::Date from, Calendar::Date to);
     static void save(const std::string &client_id, const ClientData &data);
 
+    // The details plus only the given years' entries for sharded clients; a
+    // single-file client is read whole. Archived months are not merged in.
+    static ClientData load_years(const std::string &client_id, const std::set<std::string> &years);
+    // Writes the details and the given years' shards from data and leaves the
+    // other shards alone. A single-file client is written whole, so data must
+    // come from load_years.
+    static void save_years(const std::string &client_id, const ClientData &data,
+                           const std::set<std::string> &years);
+
     static void add_work_log(const std::string &client_id,
                              const std::string &date,
                              double hours,
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include "storage/client.hpp"
+
+// Decodes client, meta, shard and archive files into ClientData and
+// WorkLogTable. Read-only commands turn on the on-demand path, which walks the
+// file with simdjson instead of building a nlohmann DOM first; it is only
+// there when wlog is built with simdjson. Both paths decode the same data.
+// contents may be grown to fit simdjson's padding.
+class ClientDecoder
+{
+public:
+    static bool available();
+    static void set_on_demand(bool enabled);
+    // True when the on-demand path is both requested and available.
+    static bool get_on_demand();
+
+    // Also collects a meta.json's shard years into shards when given.
+    static ClientData decode_client(std::string &contents, std::set<std::string> *shards = nullptr);
+    static WorkLogTable decode_logs(std::string &contents);
+};
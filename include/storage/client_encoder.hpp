@@ -0,0 +1,22 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include "storage/client.hpp"
+
+// Writes client, meta, shard and archive files straight from ClientData and
+// WorkLogTable into one buffer, without building a nlohmann DOM first. Pretty
+// output matches nlohmann's dump(2) byte for byte; compact output matches
+// dump(). Messages follow WorkLogTable's encoding.
+class ClientEncoder
+{
+public:
+    static void set_format(JsonFormat format);
+    static JsonFormat get_format();
+
+    static std::string encode_client(const ClientData &data, JsonFormat format = get_format());
+    // A sharded client's meta.json: the client without logs, plus its shard years.
+    static std::string encode_meta(const ClientData &data, const std::set<std::string> &shards,
+                                   JsonFormat format = get_format());
+    static std::string encode_logs(WorkLogTable::Range rows, JsonFormat format = get_format());
+};
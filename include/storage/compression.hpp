@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// zstd frames with the content size recorded, as written by the archive and
+// backups.
+namespace Compression
+{
+    std::string compress(std::string_view input, int level);
+
+    // what names the data in the error thrown for a corrupt frame.
+    std::string decompress(std::string_view input, const std::string &what);
+}
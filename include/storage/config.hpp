@@ -22,16 +22,77 @@ struct CompanyConfig
     )
 };
 
+enum class DurabilityPolicy
+{
+    PerWrite,
+    PerBatch,
+    None
+};
+
+// Unknown values fall back to the first (safest) entry.
+NLOHMANN_JSON_SERIALIZE_ENUM(DurabilityPolicy, {
+    {DurabilityPolicy::PerWrite, "per-write"},
+    {DurabilityPolicy::PerBatch, "per-batch"},
+    {DurabilityPolicy::None, "none"},
+})
+
+enum class ClientLayout
+{
+    SingleFile,
+    Sharded
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(ClientLayout, {
+    {ClientLayout::SingleFile, "single"},
+    {ClientLayout::Sharded, "sharded"},
+})
+
+enum class MessageEncoding
+{
+    Inline,
+    Dictionary
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(MessageEncoding, {
+    {MessageEncoding::Inline, "inline"},
+    {MessageEncoding::Dictionary, "dictionary"},
+})
+
+enum class JsonFormat
+{
+    Pretty,
+    Compact
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(JsonFormat, {
+    {JsonFormat::Pretty, "pretty"},
+    {JsonFormat::Compact, "compact"},
+})
+
+struct StorageConfig
+{
+    DurabilityPolicy durability = DurabilityPolicy::PerBatch;
+    ClientLayout layout = ClientLayout::SingleFile;
+    int archive_after_months = 12;
+    MessageEncoding message_encoding = MessageEncoding::Inline;
+    JsonFormat json_format = JsonFormat::Pretty;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(StorageConfig, durability, layout, archive_after_months,
+                                                message_encoding, json_format)
+};
+
 struct AppConfig
 {
     CompanyConfig company;
+    StorageConfig storage;
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(AppConfig, company)
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(AppConfig, company, storage)
 };
 
 class ConfigManager
 {
 public:
+    // The current DataRoot's directory, by default $HOME/.wlog.
     static std::string get_config_dir();
     static std::string get_config_path();
     static std::string get_clients_dir();
@@ -41,4 +102,8 @@ public:
     static AppConfig load();
     static void save(const AppConfig &config);
     static void ensure_directories();
+
+    // Durability, message encoding and JSON format are process-wide; the
+    // layout applies to the current root.
+    static void apply_storage_config(const StorageConfig &storage);
 };
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include "storage/config.hpp"
+
+// A wlog data directory and the per-directory storage settings. ConfigManager,
+// ClientManager and everything built on them act on the calling thread's
+// current root: the one bound with a Scope, or else the default $HOME/.wlog.
+// Threads bound to different roots can work side by side; parallel_for
+// carries the caller's root into its workers.
+class DataRoot
+{
+public:
+    explicit DataRoot(std::string dir, ClientLayout layout = ClientLayout::SingleFile);
+
+    const std::string &dir() const { return dir_; }
+    ClientLayout layout() const { return layout_; }
+    void set_layout(ClientLayout layout) { layout_ = layout; }
+
+    // Binds root to the calling thread for the scope's lifetime. Scopes nest.
+    class Scope
+    {
+    public:
+        explicit Scope(DataRoot *root);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        DataRoot *previous_;
+    };
+
+    // The calling thread's root, or nullptr when it uses the default.
+    static DataRoot *current();
+
+private:
+    std::string dir_;
+    ClientLayout layout_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "storage/config.hpp"
+
+namespace DurableFile
+{
+    void set_policy(DurabilityPolicy policy);
+    DurabilityPolicy get_policy();
+
+    // Replaces path atomically (temp file + rename). Under PerBatch, writes made
+    // while a WriteBatch is open are held in memory until the batch commits.
+    void write(const std::string &path, const std::string &contents);
+    void remove(const std::string &path);
+
+    // Reads see writes still pending in an open WriteBatch.
+    bool read(const std::string &path, std::string &contents);
+    bool read_pending(const std::string &path, std::string &contents);
+    bool exists(const std::string &path);
+}
+
+// Groups writes so a whole batch shares one fsync per file and directory.
+// Batches nest: only the outermost one commits. Dropping an uncommitted
+// batch discards its pending writes. A batch covers the writes of the thread
+// that opened it.
+class WriteBatch
+{
+public:
+    WriteBatch();
+    ~WriteBatch();
+
+    WriteBatch(const WriteBatch &) = delete;
+    WriteBatch &operator=(const WriteBatch &) = delete;
+
+    void commit();
+
+    // Whether the calling thread has a batch open.
+    static bool active();
+    // Runs fn once when the thread's outermost batch ends: at the start of
+    // commit(), so fn can still add writes, or with committed == false when
+    // the batch is dropped instead.
+    static void on_finish(std::function<void(bool committed)> fn);
+
+private:
+    bool owner_;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Append-only store of distinct work log messages. Ids and views stay valid
+// for the lifetime of the pool. Not thread-safe.
+class MessagePool
+{
+public:
+    uint32_t intern(std::string_view message);
+    std::string_view get(uint32_t id) const { return strings_[id]; }
+
+    size_t size() const { return strings_.size(); }
+    size_t text_bytes() const { return text_bytes_; }
+
+private:
+    std::pmr::deque<std::pmr::string> strings_;
+    std::pmr::unordered_map<std::string_view, uint32_t> ids_;
+    size_t text_bytes_ = 0;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Calls fn(0) .. fn(count - 1) on up to threads workers (0: one per core).
+// Indices are handed out dynamically; the first exception is rethrown once
+// all workers have finished.
+void parallel_for(size_t count, unsigned threads, const std::function<void(size_t)> &fn);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <nlohmann/json.hpp>
+#include "storage/client.hpp"
+
+struct ClientSummary
+{
+    std::string name;
+    std::string tag;
+    double hourly_rate = 0.0;
+    std::string last_month;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ClientSummary, name, tag, hourly_rate, last_month)
+
+    bool operator==(const ClientSummary &other) const
+    {
+        return name == other.name && tag == other.tag &&
+               hourly_rate == other.hourly_rate && last_month == other.last_month;
+    }
+};
+
+class ClientRegistry
+{
+public:
+    static std::string get_registry_path();
+
+    // Rebuilds the registry from the client files when it does not exist yet.
+    static std::map<std::string, ClientSummary> load();
+    static std::map<std::string, ClientSummary> rebuild();
+
+    static ClientSummary summarize(const ClientData &data);
+    static void update(const std::string &client_id, const ClientData &data);
+    static void record_activity(const std::string &client_id, const std::string &month_key);
+};
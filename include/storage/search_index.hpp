@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "calendar/date.hpp"
+
+struct SearchResult
+{
+    std::string client_id;
+    Calendar::Date date;
+    double hours = 0.0;
+    std::string message;
+};
+
+// Inverted index from message tokens to (client, date) postings, kept in
+// search.idx together with each entry's hours and message. The file is mapped
+// and binary-searched in place, so a search never reads client storage. New
+// logs and removals go to a small journal that is folded into the index every
+// JOURNAL_LIMIT entries. Both are derived from client storage and can be
+// rebuilt from it.
+class SearchIndex
+{
+public:
+    static constexpr size_t JOURNAL_LIMIT = 256;
+
+    static std::string get_index_path();
+    static std::string get_journal_path();
+
+    // Lowercased runs of letters and digits, each once, in order of appearance.
+    static std::vector<std::string> tokenize(std::string_view text);
+
+    // Records a work log. Does nothing until the index has been built.
+    static void record(const std::string &client_id, Calendar::Date date, double hours,
+                       std::string_view message);
+    // Drops client_id's entries from from to to, for logs removed from client
+    // storage. Does nothing until the index has been built.
+    static void forget(const std::string &client_id, Calendar::Date from, Calendar::Date to);
+    static void rebuild();
+
+    // Entries (archived ones included) whose message contains every term of
+    // query, sorted by client and date. client_id and from/to narrow the
+    // search when set. Builds the index if missing.
+    static std::vector<SearchResult> search(const std::string &query,
+                                            const std::string &client_id = "",
+                                            Calendar::Date from = Calendar::Date(),
+                                            Calendar::Date to = Calendar::Date(99991231));
+};
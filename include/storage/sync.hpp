@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include "storage/work_log_table.hpp"
+
+struct SyncResult
+{
+    size_t clients = 0;
+    size_t pushed = 0;
+    size_t pulled = 0;
+    size_t merged = 0;
+};
+
+// Exchanges client months with a shared directory (a mounted drive or a
+// synced folder). The directory holds clients/<id>/index.json, listing each
+// month's content hash next to the client's details, and one
+// clients/<id>/<YYYY-MM>.json per month.
+//
+// Every machine remembers the hashes it last agreed on (sync.json in the
+// config dir). A month that changed only locally is pushed, one that changed
+// only remotely is pulled, and one that changed on both sides is merged per
+// date: dates from either side are kept and a date edited on both resolves
+// to the entry with more hours, then the greater message, so every machine
+// ends up with the same month. The client's details (name, addresses, rate,
+// payment terms, tag) sync the same way as one unit; when both sides changed
+// them, the side with the greater hash wins. A client whose files and remote
+// index are unchanged since the last sync is not even loaded, and of a
+// sharded client only the years whose shard or remote months changed are
+// read and hashed. Archived months are left alone.
+class SyncManager
+{
+public:
+    static std::string get_state_path();
+
+    // Hash of a month's entries; the same entries give the same hash everywhere.
+    static std::string month_hash(const WorkLogTable &logs, const std::string &month_key);
+
+    static SyncResult run(const std::string &dir);
+};
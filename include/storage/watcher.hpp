@@ -0,0 +1,39 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+// Watches the clients directory (and each sharded client's directory) with
+// inotify and reports which clients changed. Temp files from DurableFile
+// writes are ignored; the final rename is what counts.
+class ClientWatcher
+{
+public:
+    ClientWatcher();
+    ~ClientWatcher();
+
+    ClientWatcher(const ClientWatcher &) = delete;
+    ClientWatcher &operator=(const ClientWatcher &) = delete;
+
+    static bool available();
+
+    // Blocks until something changes or timeout_ms passes (-1: forever).
+    // Events arriving within a short settle window are coalesced. Returns the
+    // changed client ids; empty on timeout.
+    std::set<std::string> wait(int timeout_ms);
+
+    // Whether the kernel queue overflowed during the last wait(), so events
+    // were lost and any client may have changed.
+    bool overflowed() const { return overflowed_; }
+
+private:
+    void watch_client_dirs();
+    void watch_client_dir(const std::string &client_id);
+    void read_events(std::set<std::string> &changed);
+
+    int fd_ = -1;
+    int root_ = -1;
+    bool overflowed_ = false;
+    std::map<int, std::string> client_dirs_;
+};
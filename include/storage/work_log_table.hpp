@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "calendar/date.hpp"
+#include "storage/config.hpp"
+#include "storage/message_pool.hpp"
+
+struct WorkLog
+{
+    double hours;
+    std::string message;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(WorkLog, hours, message)
+};
+
+struct WorkLogRow
+{
+    Calendar::Date date;
+    double hours;
+    std::string_view message;
+};
+
+// Work logs for one client as sorted parallel arrays keyed by packed
+// Calendar::Date values. Messages are interned in a MessagePool, which copies of
+// the table share and which can be shared across clients.
+class WorkLogTable
+{
+public:
+    class Range
+    {
+    public:
+        class iterator
+        {
+        public:
+            iterator(const WorkLogTable *table, size_t index) : table_(table), index_(index) {}
+
+            WorkLogRow operator*() const { return table_->row(index_); }
+            iterator &operator++()
+            {
+                ++index_;
+                return *this;
+            }
+            bool operator!=(const iterator &other) const { return index_ != other.index_; }
+            bool operator==(const iterator &other) const { return index_ == other.index_; }
+
+        private:
+            const WorkLogTable *table_;
+            size_t index_;
+        };
+
+        Range(const WorkLogTable *table, size_t begin, size_t end)
+            : table_(table), begin_(begin), end_(end) {}
+
+        iterator begin() const { return {table_, begin_}; }
+        iterator end() const { return {table_, end_}; }
+        size_t size() const { return end_ - begin_; }
+        bool empty() const { return begin_ == end_; }
+        double total_hours() const;
+
+    private:
+        const WorkLogTable *table_;
+        size_t begin_;
+        size_t end_;
+    };
+
+    // Map-style adapter: table["2026-01"]["2026-01-15"].hours
+    class EntryRef
+    {
+    public:
+        EntryRef(WorkLogTable &table, size_t index);
+
+        EntryRef &operator=(const WorkLog &log);
+
+        double &hours;
+        std::string_view message;
+
+    private:
+        WorkLogTable &table_;
+        size_t index_;
+    };
+
+    class MonthRef
+    {
+    public:
+        MonthRef(WorkLogTable &table, Calendar::Date month) : table_(table), month_(month) {}
+
+        EntryRef operator[](const std::string &date);
+        size_t count(const std::string &date) const;
+        size_t size() const { return table_.month(month_).size(); }
+        bool empty() const { return table_.month(month_).empty(); }
+        Range::iterator begin() const { return table_.month(month_).begin(); }
+        Range::iterator end() const { return table_.month(month_).end(); }
+
+    private:
+        WorkLogTable &table_;
+        Calendar::Date month_;
+    };
+
+    static void set_encoding(MessageEncoding encoding);
+    static MessageEncoding get_encoding();
+
+    size_t size() const { return dates_.size(); }
+    bool empty() const { return dates_.empty(); }
+    Calendar::Date first_date() const { return Calendar::Date(dates_.front()); }
+    Calendar::Date last_date() const { return Calendar::Date(dates_.back()); }
+
+    // Ranges are inclusive of both ends.
+    Range all() const { return {this, 0, size()}; }
+    Range between(Calendar::Date from, Calendar::Date to) const;
+    Range month(Calendar::Date month) const { return between(month.month_start(), month.month_end()); }
+    Range month(const std::string &month_key) const { return month(Calendar::parse_month(month_key)); }
+    std::vector<Calendar::Date> months() const;
+
+    WorkLogRow row(size_t index) const;
+    const std::pmr::vector<uint32_t> &dates() const { return dates_; }
+    const std::pmr::vector<double> &hours() const { return hours_; }
+    const std::shared_ptr<MessagePool> &pool() const { return pool_; }
+
+    // Re-interns all messages into the given pool.
+    void share_pool(const std::shared_ptr<MessagePool> &pool);
+
+    void set(Calendar::Date date, double hours, std::string_view message);
+    void set(const std::string &date, double hours, std::string_view message);
+    bool contains(Calendar::Date date) const;
+    void erase(Calendar::Date from, Calendar::Date to);
+    void merge(const WorkLogTable &other, bool overwrite = true);
+    WorkLogTable slice(Calendar::Date from, Calendar::Date to) const;
+
+    size_t count(const std::string &month_key) const { return month(month_key).empty() ? 0 : 1; }
+    MonthRef operator[](const std::string &month_key) { return {*this, Calendar::parse_month(month_key)}; }
+
+private:
+    size_t lower_bound(Calendar::Date date) const;
+    size_t insert_at(size_t index, Calendar::Date date);
+    void set_message(size_t index, std::string_view message);
+
+    std::pmr::vector<uint32_t> dates_;
+    std::pmr::vector<double> hours_;
+    std::pmr::vector<uint32_t> message_ids_;
+    std::shared_ptr<MessagePool> pool_;
+};
+
+void to_json(nlohmann::json &j, const WorkLogTable &table);
+void from_json(const nlohmann::json &j, WorkLogTable &table);
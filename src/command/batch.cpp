@@ -0,0 +1,352 @@
+#include "command/batch.hpp"
+#include "calendar/date.hpp"
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/archive.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/registry.hpp"
+#include "storage/search_index.hpp"
+#include "invoice/generator.hpp"
+#include "report/work_log.hpp"
+#include "query/query.hpp"
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+class BatchSession
+{
+public:
+    nlohmann::json execute(const WlogOptions &opts);
+
+    // Hands dirty clients to the open WriteBatch and commits it.
+    void checkpoint();
+
+private:
+    ClientData &client(const std::string &client_id);
+    void flush();
+
+    nlohmann::json log(const WlogOptions &opts);
+    nlohmann::json show(const WlogOptions &opts);
+    nlohmann::json show_all(const WlogOptions &opts);
+    nlohmann::json list_clients();
+    nlohmann::json search(const WlogOptions &opts);
+    nlohmann::json query(const WlogOptions &opts);
+    nlohmann::json archive(const WlogOptions &opts);
+
+    WriteBatch batch_;
+    std::map<std::string, ClientData> clients_;
+    std::set<std::string> dirty_;
+};
+
+static Calendar::Date resolve_month(const WlogOptions &opts, Calendar::Date today)
+{
+    if (opts.today_only || opts.month.empty())
+        return today.month_start();
+
+    Calendar::Date month = Calendar::parse_month(opts.month);
+    if (!month.valid())
+        throw std::runtime_error("Invalid month: " + opts.month);
+    return month;
+}
+
+// The dates a show covers: an explicit range, today, or a month.
+static void resolve_window(const WlogOptions &opts, Calendar::Date today,
+                           Calendar::Date &from, Calendar::Date &to, nlohmann::json &result)
+{
+    if (resolve_show_range(opts, today, from, to))
+    {
+        result["from"] = Calendar::iso(from).str();
+        result["to"] = Calendar::iso(to).str();
+        return;
+    }
+
+    Calendar::Date month = resolve_month(opts, today);
+    from = opts.today_only ? today : month.month_start();
+    to = opts.today_only ? today : month.month_end();
+    result["month"] = Calendar::month_key(month).str();
+}
+
+ClientData &BatchSession::client(const std::string &client_id)
+{
+    auto it = clients_.find(client_id);
+    if (it != clients_.end())
+        return it->second;
+
+    if (!ClientManager::client_exists(client_id))
+        throw std::runtime_error("Client not found: " + client_id);
+
+    return clients_.emplace(client_id, ClientManager::load(client_id)).first->second;
+}
+
+void BatchSession::flush()
+{
+    for (const auto &client_id : dirty_)
+    {
+        ClientManager::save(client_id, clients_.at(client_id));
+    }
+    dirty_.clear();
+}
+
+void BatchSession::checkpoint()
+{
+    flush();
+    batch_.commit();
+}
+
+nlohmann::json BatchSession::execute(const WlogOptions &opts)
+{
+    if (opts.setup || opts.batch || opts.reindex || opts.watch || !opts.export_format.empty() ||
+        !opts.merge.empty() || !opts.sync.empty() || !opts.backup.empty() || !opts.restore.empty() ||
+        !opts.snapshots.empty())
+        throw std::runtime_error("Command is not supported in batch mode");
+
+    if (opts.list_clients)
+        return list_clients();
+    if (opts.archive)
+        return archive(opts);
+    if (!opts.search.empty())
+        return search(opts);
+    if (!opts.query.empty())
+        return query(opts);
+    if (opts.all)
+    {
+        if (!opts.show)
+            throw std::runtime_error("--all is only supported with --show");
+        return show_all(opts);
+    }
+
+    if (opts.client.empty())
+        throw std::runtime_error("Missing client");
+
+    if (opts.invoice || opts.report)
+    {
+        // Generators read through storage, which sees flushed but uncommitted writes.
+        client(opts.client);
+        flush();
+
+        nlohmann::json result = {{"command", opts.invoice ? "invoice" : "report"}, {"client", opts.client}};
+        if (opts.invoice)
+            result["invoice"] = InvoiceGenerator::generate(opts.client, opts.month);
+        if (opts.report)
+            result["report"] = WorkLogReport::generate(opts.client, opts.month, report_format(opts));
+
+        // Invoicing bumps the invoice number on disk.
+        clients_.erase(opts.client);
+        return result;
+    }
+
+    if (opts.show)
+        return show(opts);
+    if (opts.hours <= 0)
+        throw std::runtime_error("Hours must be greater than zero");
+    return log(opts);
+}
+
+nlohmann::json BatchSession::log(const WlogOptions &opts)
+{
+    std::string date = opts.day.empty() ? Calendar::iso(Calendar::today()).str() : opts.day;
+    if (!Calendar::parse_date(date).valid())
+        throw std::runtime_error("Invalid date: " + date);
+
+    ClientData &data = client(opts.client);
+    data.logs.set(date, opts.hours, opts.message);
+    dirty_.insert(opts.client);
+    SearchIndex::record(opts.client, Calendar::parse_date(date), opts.hours, opts.message);
+
+    return {{"command", "log"},
+            {"client", opts.client},
+            {"date", date},
+            {"hours", opts.hours},
+            {"message", opts.message}};
+}
+
+nlohmann::json BatchSession::show(const WlogOptions &opts)
+{
+    Calendar::Date today = Calendar::today();
+    nlohmann::json result = {{"command", "show"}, {"client", opts.client}};
+
+    Calendar::Date from, to;
+    resolve_window(opts, today, from, to, result);
+
+    const ClientData &data = client(opts.client);
+
+    // Archived months are read on demand and never enter the session.
+    WorkLogTable archived;
+    auto month = data.archived_months.lower_bound(Calendar::month_key(from).str());
+    if (month != data.archived_months.end() && *month <= Calendar::month_key(to).view())
+        archived = ArchiveManager::load(opts.client).slice(from, to);
+
+    WorkLogTable::Range rows = data.logs.between(from, to);
+    if (!archived.empty())
+    {
+        archived.merge(data.logs.slice(from, to));
+        rows = archived.all();
+    }
+
+    nlohmann::json entries = nlohmann::json::array();
+    for (const auto &row : rows)
+    {
+        entries.push_back({{"date", Calendar::iso(row.date).str()},
+                           {"hours", row.hours},
+                           {"message", std::string(row.message)}});
+    }
+
+    result["name"] = data.name;
+    result["entries"] = std::move(entries);
+    result["total_hours"] = rows.total_hours();
+    return result;
+}
+
+nlohmann::json BatchSession::show_all(const WlogOptions &opts)
+{
+    Calendar::Date today = Calendar::today();
+    nlohmann::json result = {{"command", "show"}};
+
+    Calendar::Date from, to;
+    resolve_window(opts, today, from, to, result);
+
+    flush();
+    std::map<std::string, ClientData> clients = BatchLoader::load_all();
+
+    nlohmann::json rows = nlohmann::json::array();
+    double total = 0.0;
+    for (const auto &[id, data] : clients)
+    {
+        double hours = data.logs.between(from, to).total_hours();
+        if (hours <= 0)
+            continue;
+
+        rows.push_back({{"client", id}, {"name", data.name}, {"hours", hours}});
+        total += hours;
+    }
+
+    result["clients"] = std::move(rows);
+    result["total_hours"] = total;
+    return result;
+}
+
+nlohmann::json BatchSession::list_clients()
+{
+    flush();
+
+    nlohmann::json clients = nlohmann::json::array();
+    for (const auto &[id, summary] : ClientRegistry::load())
+    {
+        clients.push_back({{"client", id},
+                           {"name", summary.name},
+                           {"tag", summary.tag},
+                           {"hourly_rate", summary.hourly_rate},
+                           {"last_month", summary.last_month}});
+    }
+    return {{"command", "clients"}, {"clients", std::move(clients)}};
+}
+
+nlohmann::json BatchSession::search(const WlogOptions &opts)
+{
+    Calendar::Date from, to(99991231);
+    resolve_show_range(opts, Calendar::today(), from, to);
+
+    nlohmann::json entries = nlohmann::json::array();
+    double total = 0.0;
+    for (const auto &result : SearchIndex::search(opts.search, opts.client, from, to))
+    {
+        entries.push_back({{"client", result.client_id},
+                           {"date", Calendar::iso(result.date).str()},
+                           {"hours", result.hours},
+                           {"message", result.message}});
+        total += result.hours;
+    }
+    return {{"command", "search"},
+            {"query", opts.search},
+            {"entries", std::move(entries)},
+            {"total_hours", total}};
+}
+
+nlohmann::json BatchSession::query(const WlogOptions &opts)
+{
+    flush();
+    Query::Result result = Query::run(opts.query);
+
+    nlohmann::json rows = nlohmann::json::array();
+    for (const auto &row : result.rows)
+    {
+        nlohmann::json j;
+        for (size_t k = 0; k < row.keys.size(); k++)
+            j[result.key_names[k]] = row.keys[k];
+        for (size_t v = 0; v < row.values.size(); v++)
+            j[result.value_names[v]] = row.values[v];
+        rows.push_back(std::move(j));
+    }
+    return {{"command", "query"}, {"query", opts.query}, {"rows", std::move(rows)}};
+}
+
+nlohmann::json BatchSession::archive(const WlogOptions &opts)
+{
+    flush();
+
+    // run_archive reports on stdout; keep its text in the result instead.
+    std::ostringstream output;
+    std::streambuf *previous = std::cout.rdbuf(output.rdbuf());
+    try
+    {
+        run_archive(opts);
+    }
+    catch (...)
+    {
+        std::cout.rdbuf(previous);
+        throw;
+    }
+    std::cout.rdbuf(previous);
+
+    clients_.clear();
+    return {{"command", "archive"}, {"output", output.str()}};
+}
+
+int run_batch(std::istream &in, std::ostream &out, const BatchParser &parse, unsigned checkpoint_every)
+{
+    BatchSession session;
+    std::string line;
+    size_t line_number = 0;
+    unsigned since_checkpoint = 0;
+    bool all_ok = true;
+
+    while (std::getline(in, line))
+    {
+        line_number++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#')
+            continue;
+
+        nlohmann::json result;
+        WlogOptions opts;
+        std::string error;
+        try
+        {
+            if (!parse(line, opts, error))
+                throw std::runtime_error(error);
+
+            result = session.execute(opts);
+            result["ok"] = true;
+        }
+        catch (const std::exception &e)
+        {
+            result = {{"ok", false}, {"error", e.what()}};
+            all_ok = false;
+        }
+        result["line"] = line_number;
+        out << result.dump() << '\n';
+
+        if (checkpoint_every > 0 && ++since_checkpoint >= checkpoint_every)
+        {
+            session.checkpoint();
+            since_checkpoint = 0;
+        }
+    }
+
+    session.checkpoint();
+    out.flush();
+    return all_ok ? 0 : 1;
+}
@@ -1,32 +1,39 @@
 #include "command/log.hpp"
+#include "calendar/date.hpp"
 #include "storage/config.hpp"
 #include "storage/client.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/registry.hpp"
+#include "storage/archive.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/search_index.hpp"
+#include "storage/sync.hpp"
+#include "storage/backup.hpp"
+#include "export/exporter.hpp"
+#include "query/query.hpp"
+#include "pipeline/pipeline.hpp"
+#include "merge/team_merge.hpp"
 #include "flow/setup.hpp"
 #include "flow/client.hpp"
+#include "flow/bulk_setup.hpp"
 #include "invoice/generator.hpp"
 #include "report/work_log.hpp"
 #include <iostream>
-#include <chrono>
 #include <iomanip>
-#include <sstream>
-#include <regex>
+#include <fstream>
 #include <vector>
 #include <algorithm>
+#include <map>
+#include <stdexcept>
 
 static std::string get_today()
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&now_time);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d");
-    return oss.str();
+    return Calendar::iso(Calendar::today()).str();
 }
 
 static bool is_valid_date(const std::string &date)
 {
-    std::regex date_regex("^\\d{4}-\\d{2}-\\d{2}$");
-    return std::regex_match(date, date_regex);
+    return Calendar::parse_date(date).valid();
 }
 
 void run_setup()
@@ -39,19 +46,40 @@ void run_client_setup(const std::string &client)
     ClientFlow::start(client);
 }
 
+void run_bulk_setup(const WlogOptions &opts)
+{
+    BulkSetupResult result;
+    if (opts.from == "-")
+    {
+        result = BulkSetup::apply(std::cin);
+    }
+    else
+    {
+        std::ifstream in(opts.from);
+        if (!in)
+            throw std::runtime_error("Could not open " + opts.from);
+        result = BulkSetup::apply(in);
+    }
+
+    if (result.config_saved)
+        std::cout << "Business configuration saved." << std::endl;
+    std::cout << "Clients: " << result.created << " created, " << result.updated << " updated, "
+              << result.unchanged << " unchanged." << std::endl;
+}
+
 void run_log(const WlogOptions &opts)
 {
     std::string date = opts.day.empty() ? get_today() : opts.day;
 
     if (!is_valid_date(date))
     {
-        std::cerr << "Invalid date format. Use YYYY-MM-DD." << std::endl;
+        std::cerr << "Invalid date. Use YYYY-MM-DD." << std::endl;
         return;
     }
 
     ClientManager::add_work_log(opts.client, date, opts.hours, opts.message);
 
-    ClientData client = ClientManager::load(opts.client);
+    ClientData client = ClientManager::load(opts.client, date.substr(0, 7));
     std::cout << std::endl << "Logged " << opts.hours << " hours for " << client.name
               << " on " << date;
     if (!opts.message.empty())
@@ -59,85 +87,435 @@ void run_log(const WlogOptions &opts)
     std::cout << std::endl;
 }
 
+static void resolve_show_month(const WlogOptions &opts, Calendar::Date today,
+                               std::string &month_key, std::string &month_display)
+{
+    if (opts.today_only)
+    {
+        month_key = Calendar::month_key(today).str();
+        month_display = "Today";
+    }
+    else if (opts.month.empty())
+    {
+        month_key = Calendar::month_key(today).str();
+        month_display = Calendar::month_title(today).str();
+    }
+    else
+    {
+        month_key = opts.month;
+        Calendar::Date month = Calendar::parse_month(opts.month);
+        month_display = month.valid() ? Calendar::month_title(month).str() : opts.month;
+    }
+}
+
+ReportFormat report_format(const WlogOptions &opts)
+{
+    return opts.format.empty() ? ReportFormat::Pdf : WorkLogReport::parse_format(opts.format);
+}
+
+bool resolve_show_range(const WlogOptions &opts, Calendar::Date today,
+                        Calendar::Date &from, Calendar::Date &to)
+{
+    if (opts.week)
+    {
+        from = Calendar::add_days(today, -Calendar::weekday(today));
+        to = Calendar::add_days(from, 6);
+        return true;
+    }
+
+    if (opts.last > 0)
+    {
+        from = Calendar::add_days(today, 1 - static_cast<int>(opts.last));
+        to = today;
+        return true;
+    }
+
+    if (opts.from.empty())
+    {
+        if (!opts.to.empty())
+            throw std::runtime_error("--to requires --from");
+        return false;
+    }
+
+    from = Calendar::parse_date(opts.from);
+    to = opts.to.empty() ? today : Calendar::parse_date(opts.to);
+    if (!from.valid() || !to.valid())
+        throw std::runtime_error("Invalid date range. Use YYYY-MM-DD.");
+    if (to < from)
+        throw std::runtime_error("--to is before --from");
+    return true;
+}
+
+// Prints a client's logs as the pipeline produces them. A month or a day is
+// one line per log; a range is grouped by month with a running total.
+class TerminalSink : public Pipeline::Sink
+{
+public:
+    TerminalSink(std::string title, std::string empty_message, bool grouped)
+        : title_(std::move(title)), empty_message_(std::move(empty_message)), grouped_(grouped)
+    {
+    }
+
+    void begin(const ClientData &client) override
+    {
+        std::cout << client.name << " - " << title_ << std::endl;
+        std::cout << std::string(40, '-') << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+    }
+
+    void row(const WorkLogRow &row) override
+    {
+        total_ += row.hours;
+        if (!grouped_)
+        {
+            std::cout << Calendar::short_date(row.date) << "   " << row.hours << "h   " << row.message << '\n';
+            return;
+        }
+
+        if (row.date.month_start() != month_)
+        {
+            month_ = row.date.month_start();
+            std::cout << Calendar::month_title(month_) << '\n';
+        }
+        std::cout << "  " << Calendar::short_date(row.date) << "   "
+                  << std::setw(5) << row.hours << "h  "
+                  << std::setw(7) << total_ << "h   "
+                  << row.message << '\n';
+    }
+
+    void finish(const Pipeline::Summary &summary) override
+    {
+        if (summary.entries == 0)
+        {
+            std::cout << empty_message_ << std::endl;
+            return;
+        }
+        std::cout << std::string(40, '-') << std::endl;
+        std::cout << "Total: " << summary.hours << " hours" << std::endl;
+    }
+
+private:
+    std::string title_;
+    std::string empty_message_;
+    bool grouped_;
+    Calendar::Date month_;
+    double total_ = 0.0;
+};
+
 void run_show(const WlogOptions &opts)
 {
-    ClientData client = ClientManager::load(opts.client);
-    std::string today_date = get_today();
+    Calendar::Date today = Calendar::today();
+
+    Calendar::Date from, to;
+    if (resolve_show_range(opts, today, from, to))
+    {
+        TerminalSink sink(Calendar::long_date(from).str() + " to " + Calendar::long_date(to).str(),
+                          "No logs in this range.", true);
+        Pipeline::Source(opts.client, from, to).run(sink);
+        return;
+    }
 
     std::string month_key;
     std::string month_display;
+    resolve_show_month(opts, today, month_key, month_display);
 
+    TerminalSink sink(month_display, std::string("No logs for this ") + (opts.today_only ? "day" : "month") + ".",
+                      false);
     if (opts.today_only)
+        Pipeline::Source(opts.client, today, today).run(sink);
+    else
+        Pipeline::Source::month(opts.client, month_key).run(sink);
+}
+
+void run_show_all(const WlogOptions &opts)
+{
+    std::map<std::string, ClientData> clients = BatchLoader::load_all();
+    Calendar::Date today = Calendar::today();
+
+    std::string month_key;
+    std::string month_display;
+    resolve_show_month(opts, today, month_key, month_display);
+
+    Calendar::Date from = today, to = today;
+    bool range = resolve_show_range(opts, today, from, to);
+    if (range)
     {
-        month_key = today_date.substr(0, 7);
-        month_display = "Today";
+        month_display = Calendar::long_date(from).str() + " to " + Calendar::long_date(to).str();
     }
-    else if (opts.month.empty())
+    else if (!opts.today_only)
     {
-        auto now = std::chrono::system_clock::now();
-        auto now_time = std::chrono::system_clock::to_time_t(now);
-        std::tm tm = *std::localtime(&now_time);
-        std::ostringstream month_oss;
-        month_oss << std::put_time(&tm, "%Y-%m");
-        month_key = month_oss.str();
-        std::ostringstream name_oss;
-        name_oss << std::put_time(&tm, "%B %Y");
-        month_display = name_oss.str();
+        from = Calendar::parse_month(month_key);
+        to = from.month_end();
     }
-    else
+
+    std::cout << "All clients - " << month_display << std::endl;
+    std::cout << std::string(40, '-') << std::endl;
+
+    double total = 0.0;
+    for (auto &[id, client] : clients)
     {
-        month_key = opts.month;
-        std::tm tm = {};
-        std::istringstream ss(opts.month + "-01");
-        ss >> std::get_time(&tm, "%Y-%m-%d");
-        std::ostringstream name_oss;
-        name_oss << std::put_time(&tm, "%B %Y");
-        month_display = name_oss.str();
+        ClientManager::merge_archive(id, client, from, to);
+        double hours = client.logs.between(from, to).total_hours();
+
+        if (hours <= 0)
+            continue;
+
+        std::cout << std::left << std::setw(28) << client.name << std::right
+                  << std::fixed << std::setprecision(1) << hours << "h" << std::endl;
+        total += hours;
     }
 
-    std::cout << client.name << " - " << month_display << std::endl;
     std::cout << std::string(40, '-') << std::endl;
+    std::cout << "Total: " << std::fixed << std::setprecision(1) << total << " hours" << std::endl;
+}
+
+void run_list_clients()
+{
+    std::map<std::string, ClientSummary> registry = ClientRegistry::load();
 
-    if (client.logs.count(month_key) == 0 || client.logs.at(month_key).empty())
+    if (registry.empty())
     {
-        std::cout << "No logs for this " << (opts.today_only ? "day" : "month") << "." << std::endl;
+        std::cout << "No clients yet." << std::endl;
         return;
     }
 
-    std::vector<std::pair<std::string, WorkLog>> sorted_logs;
-    for (const auto &[date, log] : client.logs.at(month_key))
+    for (const auto &[id, client] : registry)
     {
-        if (opts.today_only && date != today_date)
-            continue;
-        sorted_logs.push_back({date, log});
+        std::cout << std::left << std::setw(16) << id
+                  << std::setw(28) << client.name
+                  << std::setw(8) << client.tag << std::right
+                  << std::setw(10) << std::fixed << std::setprecision(2) << client.hourly_rate << "/h   "
+                  << (client.last_month.empty() ? "-" : client.last_month) << std::endl;
     }
+}
 
-    if (sorted_logs.empty())
+void run_archive(const WlogOptions &opts)
+{
+    AppConfig config = ConfigManager::load();
+    std::string cutoff = ArchiveManager::get_cutoff_month(config.storage.archive_after_months);
+
+    std::vector<std::string> client_ids;
+    if (opts.client.empty())
+    {
+        client_ids = BatchLoader::list_client_ids();
+    }
+    else
     {
-        std::cout << "No logs for today." << std::endl;
+        if (!ClientManager::client_exists(opts.client))
+        {
+            throw std::runtime_error("Client not found: " + opts.client);
+        }
+        client_ids.push_back(opts.client);
+    }
+
+    WriteBatch batch;
+    int total = 0;
+    for (const auto &client_id : client_ids)
+    {
+        int moved = ArchiveManager::archive_client(client_id, cutoff);
+        if (moved > 0)
+        {
+            std::cout << "Archived " << moved << " month" << (moved == 1 ? "" : "s")
+                      << " for " << client_id << std::endl;
+        }
+        total += moved;
+    }
+    batch.commit();
+
+    if (total == 0)
+    {
+        std::cout << "Nothing to archive before " << cutoff << "." << std::endl;
+    }
+}
+
+void run_export(const WlogOptions &opts)
+{
+    ExportFormat format = Exporter::parse_format(opts.export_format);
+
+    std::vector<std::string> client_ids;
+    if (!opts.client.empty())
+        client_ids.push_back(opts.client);
+
+    if (opts.output.empty() || opts.output == "-")
+    {
+        Exporter::write(std::cout, format, client_ids);
+        std::cout.flush();
         return;
     }
 
-    std::sort(sorted_logs.begin(), sorted_logs.end(),
-              [](const auto &a, const auto &b) { return a.first < b.first; });
+    std::ofstream file(opts.output, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Could not open " + opts.output);
+
+    size_t rows = Exporter::write(file, format, client_ids);
+    file.close();
+    if (!file)
+        throw std::runtime_error("Could not write " + opts.output);
 
+    std::cerr << "Exported " << rows << " rows to " << opts.output << std::endl;
+}
+
+void run_search(const WlogOptions &opts)
+{
+    Calendar::Date from, to(99991231);
+    resolve_show_range(opts, Calendar::today(), from, to);
+
+    std::vector<SearchResult> results = SearchIndex::search(opts.search, opts.client, from, to);
+
+    std::cout << "Search: " << opts.search << std::endl;
+    std::cout << std::string(40, '-') << std::endl;
+
+    if (results.empty())
+    {
+        std::cout << "No matching logs." << std::endl;
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
     double total = 0.0;
-    for (const auto &[date, log] : sorted_logs)
+    for (const auto &result : results)
     {
-        std::tm dtm = {};
-        std::istringstream dss(date);
-        dss >> std::get_time(&dtm, "%Y-%m-%d");
-        std::ostringstream doss;
-        doss << std::put_time(&dtm, "%b %d");
+        std::cout << std::left << std::setw(16) << result.client_id << std::right
+                  << Calendar::long_date(result.date) << "   "
+                  << std::setw(5) << result.hours << "h   "
+                  << result.message << '\n';
+        total += result.hours;
+    }
 
-        std::cout << doss.str() << "   "
-                  << std::fixed << std::setprecision(1) << log.hours << "h   "
-                  << log.message << std::endl;
-        total += log.hours;
+    std::cout << std::string(40, '-') << std::endl;
+    std::cout << "Total: " << total << " hours in " << results.size()
+              << (results.size() == 1 ? " entry" : " entries") << std::endl;
+}
+
+void run_reindex()
+{
+    WriteBatch batch;
+    SearchIndex::rebuild();
+    batch.commit();
+    std::cout << "Search index rebuilt." << std::endl;
+}
+
+void run_query(const WlogOptions &opts)
+{
+    Query::Result result = Query::run(opts.query);
+
+    std::vector<size_t> widths;
+    for (const auto &name : result.key_names)
+    {
+        size_t width = name.size();
+        for (const auto &row : result.rows)
+            width = std::max(width, row.keys[widths.size()].size());
+        widths.push_back(width + 3);
     }
 
+    for (size_t k = 0; k < result.key_names.size(); k++)
+        std::cout << std::left << std::setw(static_cast<int>(widths[k])) << result.key_names[k];
+    for (const auto &name : result.value_names)
+        std::cout << std::right << std::setw(14) << name;
+    std::cout << std::endl;
     std::cout << std::string(40, '-') << std::endl;
-    std::cout << "Total: " << std::fixed << std::setprecision(1) << total << " hours" << std::endl;
+
+    if (result.rows.empty())
+    {
+        std::cout << "No matching logs." << std::endl;
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto &row : result.rows)
+    {
+        for (size_t k = 0; k < row.keys.size(); k++)
+            std::cout << std::left << std::setw(static_cast<int>(widths[k])) << row.keys[k];
+        std::cout << std::right;
+        for (double value : row.values)
+            std::cout << std::setw(14) << value;
+        std::cout << '\n';
+    }
+    std::cout.flush();
+}
+
+void run_merge(const WlogOptions &opts)
+{
+    std::vector<MergeSource> roots;
+    for (const auto &spec : opts.merge)
+        roots.push_back(TeamMerge::parse_source(spec));
+
+    if (opts.invoice)
+    {
+        std::string output = TeamMerge::generate_invoice(roots, opts.client, opts.month);
+        std::cout << "Invoice generated: " << output << std::endl;
+        return;
+    }
+    if (opts.report)
+    {
+        std::string output = TeamMerge::generate_report(roots, opts.client, opts.month, report_format(opts));
+        std::cout << "Work log report generated: " << output << std::endl;
+        return;
+    }
+
+    std::string month_key = opts.month.empty() ? ClientManager::get_previous_month_key() : opts.month;
+    size_t author_width = 0;
+    for (const auto &root : roots)
+        author_width = std::max(author_width, root.author.size());
+
+    std::cout << opts.client << " - " << Calendar::month_title(Calendar::parse_month(month_key))
+              << " (" << roots.size() << " directories)" << std::endl;
+    std::cout << std::string(40, '-') << std::endl;
+
+    // Entries print as the merge produces them; nothing is collected.
+    std::cout << std::fixed << std::setprecision(1);
+    double total = 0.0;
+    TeamMerge::merge_month(roots, opts.client, month_key, [&](const MergedEntry &entry)
+    {
+        total += entry.hours;
+        std::cout << "  " << Calendar::short_date(entry.date) << "   "
+                  << std::left << std::setw(static_cast<int>(author_width)) << *entry.author << std::right
+                  << std::setw(7) << entry.hours << "h   " << entry.message << '\n';
+    });
+
+    if (total <= 0)
+        std::cout << "No logs in this month." << std::endl;
+    std::cout << std::string(40, '-') << std::endl;
+    std::cout << "Total: " << total << " hours" << std::endl;
+}
+
+void run_sync(const WlogOptions &opts)
+{
+    SyncResult result = SyncManager::run(opts.sync);
+    if (result.clients == 0)
+    {
+        std::cout << "Already in sync." << std::endl;
+        return;
+    }
+    std::cout << "Synced " << result.clients << " client(s): " << result.pushed << " month(s) pushed, "
+              << result.pulled << " pulled, " << result.merged << " merged." << std::endl;
+}
+
+void run_backup(const WlogOptions &opts)
+{
+    BackupResult result = BackupManager::backup(opts.backup);
+    std::cout << "Snapshot " << result.snapshot << ": " << result.files << " files, "
+              << result.files_read << " changed, " << result.chunks_written << " new chunks ("
+              << result.bytes_written << " bytes)." << std::endl;
+}
+
+void run_restore(const WlogOptions &opts)
+{
+    std::string name = BackupManager::restore(opts.restore, opts.snapshot);
+    std::cout << "Restored snapshot " << name << "." << std::endl;
+}
+
+void run_list_snapshots(const WlogOptions &opts)
+{
+    std::vector<std::string> names = BackupManager::list(opts.snapshots);
+    if (names.empty())
+    {
+        std::cout << "No snapshots." << std::endl;
+        return;
+    }
+    for (const auto &name : names)
+        std::cout << name << '\n';
+    std::cout.flush();
 }
 
 void run_invoice(const WlogOptions &opts)
@@ -146,8 +524,21 @@ void run_invoice(const WlogOptions &opts)
     std::cout << "Invoice generated: " << output << std::endl;
 }
 
+void run_invoice_all(const WlogOptions &opts)
+{
+    std::vector<std::string> outputs = InvoiceGenerator::generate_all(opts.month);
+    if (outputs.empty())
+    {
+        std::cout << "No hours logged for any client." << std::endl;
+        return;
+    }
+    for (const auto &output : outputs)
+        std::cout << "Invoice generated: " << output << '\n';
+    std::cout.flush();
+}
+
 void run_report(const WlogOptions &opts)
 {
-    std::string output = WorkLogReport::generate(opts.client, opts.month);
+    std::string output = WorkLogReport::generate(opts.client, opts.month, report_format(opts));
     std::cout << "Work log report generated: " << output << std::endl;
 }
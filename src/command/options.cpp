@@ -0,0 +1,68 @@
+#include "command/options.hpp"
+#include "calendar/date.hpp"
+#include <CLI/CLI.hpp>
+
+std::string normalize_month(const std::string &month)
+{
+    if (month.empty() || month.length() > 2)
+        return month;
+
+    int month_num = std::stoi(month);
+    if (month_num < 1 || month_num > 12)
+        return month;
+    return Calendar::month_key(Calendar::Date(Calendar::today().year(), month_num, 0)).str();
+}
+
+void add_options(CLI::App &app, WlogOptions &opts)
+{
+    app.add_flag("--setup", opts.setup, "Run business or client setup");
+    app.add_option("client", opts.client, "Client identifier");
+    app.add_option("hours", opts.hours, "Hours worked");
+    app.add_option("message", opts.message, "Work description");
+    app.add_option("date", opts.day, "Date (YYYY-MM-DD), defaults to today");
+    app.add_flag("--invoice,-i", opts.invoice, "Generate invoice for previous month");
+    app.add_flag("--report,-r", opts.report, "Generate work log report");
+    app.add_option("--format", opts.format, "Report format: pdf (default), html or md (use with -r)");
+    app.add_option("--month,-m", opts.month, "Month for report (YYYY-MM), defaults to previous month");
+    app.add_flag("--show,-s", opts.show, "Show current month's work logs");
+    app.add_flag("--today,-t", opts.today_only, "Show only today's log (use with -s)");
+    app.add_option("--from", opts.from, "Show logs from this date (YYYY-MM-DD, use with -s), or set up from a manifest (use with --setup, - for stdin)");
+    app.add_option("--to", opts.to, "Show logs up to this date (YYYY-MM-DD), defaults to today");
+    app.add_flag("--week", opts.week, "Show this week's logs (use with -s)");
+    app.add_option("--last", opts.last, "Show the last N days of logs (use with -s)");
+    app.add_flag("--clients", opts.list_clients, "List all clients");
+    app.add_flag("--archive", opts.archive, "Move months older than the archive horizon into the compressed archive");
+    app.add_option("--export", opts.export_format, "Export full history as csv, jsonl or columnar");
+    app.add_option("--output,-o", opts.output, "Export destination, defaults to stdout (use with --export)");
+    app.add_option("--search", opts.search, "Find logs whose message contains all given words");
+    app.add_flag("--reindex", opts.reindex, "Rebuild the search index from storage");
+    app.add_option("--query,-q", opts.query, "Aggregate logs, e.g. \"sum(hours) where year = 2025 by month\"");
+    app.add_option("--merge", opts.merge, "Consolidate a client across data directories ([name=]DIR, repeatable)")
+        ->allow_extra_args(false);
+    app.add_option("--sync", opts.sync, "Exchange changed months with a shared directory");
+    app.add_option("--backup", opts.backup, "Write an incremental snapshot of the data directory to DEST");
+    app.add_option("--restore", opts.restore, "Restore the data directory from a snapshot in DEST");
+    app.add_option("--snapshot", opts.snapshot, "Snapshot to restore, defaults to the latest (use with --restore)");
+    app.add_option("--snapshots", opts.snapshots, "List the snapshots in DEST");
+    app.add_flag("--watch", opts.watch, "Show today's and this month's totals, redrawn as logs change");
+    app.add_flag("--all,-a", opts.all, "Show totals (-s) or invoice (-i) for all clients");
+    app.add_flag("--batch", opts.batch, "Read commands from stdin and print JSON lines");
+    app.add_option("--checkpoint", opts.checkpoint, "Flush storage every N batch commands (use with --batch)");
+}
+
+bool parse_batch_line(const std::string &line, WlogOptions &opts, std::string &error)
+{
+    CLI::App app;
+    add_options(app, opts);
+    try
+    {
+        app.parse(line, false);
+    }
+    catch (const CLI::ParseError &e)
+    {
+        error = e.what();
+        return false;
+    }
+    opts.month = normalize_month(opts.month);
+    return true;
+}
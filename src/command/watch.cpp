@@ -0,0 +1,120 @@
+#include "command/watch.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/client.hpp"
+#include "storage/watcher.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+static constexpr int MAX_SLEEP_MS = 60 * 60 * 1000;
+
+static int ms_until_midnight()
+{
+    std::time_t now = std::time(nullptr);
+    std::tm local = *std::localtime(&now);
+    int seconds = (23 - local.tm_hour) * 3600 + (59 - local.tm_min) * 60 + (60 - local.tm_sec);
+    return std::min(seconds * 1000, MAX_SLEEP_MS);
+}
+
+WatchSummary::WatchSummary(Calendar::Date today)
+{
+    refresh_all(today);
+}
+
+void WatchSummary::refresh_all(Calendar::Date today)
+{
+    today_ = today;
+    clients_.clear();
+    today_total_ = 0.0;
+    month_total_ = 0.0;
+
+    for (const auto &id : BatchLoader::list_client_ids())
+        refresh(id);
+}
+
+void WatchSummary::remove(const std::string &client_id)
+{
+    auto it = clients_.find(client_id);
+    if (it == clients_.end())
+        return;
+
+    today_total_ -= it->second.today;
+    month_total_ -= it->second.month;
+    clients_.erase(it);
+}
+
+void WatchSummary::refresh(const std::string &client_id)
+{
+    remove(client_id);
+    if (!ClientManager::client_exists(client_id))
+        return;
+
+    ClientData data;
+    try
+    {
+        data = ClientManager::load(client_id, today_.month_start(), today_.month_end());
+    }
+    catch (const std::exception &)
+    {
+        // Caught mid-write by another process; the next event brings it back.
+        return;
+    }
+
+    Entry entry;
+    entry.name = data.name;
+    entry.month = data.logs.month(today_).total_hours();
+    entry.today = data.logs.between(today_, today_).total_hours();
+
+    today_total_ += entry.today;
+    month_total_ += entry.month;
+    clients_[client_id] = std::move(entry);
+}
+
+void WatchSummary::render(std::ostream &out) const
+{
+    out << "Watching - " << Calendar::long_date(today_) << std::endl;
+    out << std::string(40, '-') << std::endl;
+    out << std::left << std::setw(24) << "Client" << std::right
+        << std::setw(8) << "Today" << std::setw(8) << "Month" << std::endl;
+
+    for (const auto &[id, entry] : clients_)
+    {
+        if (entry.month <= 0)
+            continue;
+
+        out << std::left << std::setw(24) << entry.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(7) << entry.today << "h" << std::setw(7) << entry.month << "h" << std::endl;
+    }
+
+    out << std::string(40, '-') << std::endl;
+    out << std::left << std::setw(24) << "Total" << std::right << std::fixed << std::setprecision(1)
+        << std::setw(7) << today_total_ << "h" << std::setw(7) << month_total_ << "h" << std::endl;
+}
+
+void run_watch()
+{
+    // Watch first so nothing saved during the initial load is missed.
+    ClientWatcher watcher;
+    WatchSummary summary(Calendar::today());
+
+    while (true)
+    {
+        std::cout << "\033[H\033[2J";
+        summary.render(std::cout);
+        std::cout << std::flush;
+
+        // Sleeps in poll() until a client file changes or the day may have ended.
+        std::set<std::string> changed = watcher.wait(ms_until_midnight());
+
+        Calendar::Date today = Calendar::today();
+        if (today != summary.day() || watcher.overflowed())
+        {
+            summary.refresh_all(today);
+            continue;
+        }
+        for (const auto &client_id : changed)
+            summary.refresh(client_id);
+    }
+}
@@ -0,0 +1,258 @@
+#include "export/exporter.hpp"
+#include "calendar/date.hpp"
+#include "storage/client.hpp"
+#include "storage/archive.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/message_pool.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+static constexpr size_t BUFFER_SIZE = 64 * 1024;
+static constexpr std::string_view COLUMNAR_MAGIC = "WLOGCOL1";
+
+// Collects output in one block and hands it to the stream in large writes.
+class OutputBuffer
+{
+public:
+    explicit OutputBuffer(std::ostream &out) : out_(out)
+    {
+        buffer_.reserve(BUFFER_SIZE);
+    }
+
+    void append(std::string_view text)
+    {
+        if (buffer_.size() + text.size() > BUFFER_SIZE)
+            flush();
+        if (text.size() > BUFFER_SIZE)
+            out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+        else
+            buffer_.append(text);
+    }
+
+    void push(char c)
+    {
+        if (buffer_.size() == BUFFER_SIZE)
+            flush();
+        buffer_.push_back(c);
+    }
+
+    void append_hours(double hours)
+    {
+        char text[32];
+        int size = std::snprintf(text, sizeof(text), "%.10g", hours);
+        append(std::string_view(text, static_cast<size_t>(size)));
+    }
+
+    void append_u32(uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            push(static_cast<char>(value >> (8 * i)));
+    }
+
+    void append_f64(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; i++)
+            push(static_cast<char>(bits >> (8 * i)));
+    }
+
+    void flush()
+    {
+        if (buffer_.empty())
+            return;
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+        if (!out_)
+            throw std::runtime_error("Could not write export");
+    }
+
+private:
+    std::ostream &out_;
+    std::string buffer_;
+};
+
+static void append_csv_field(OutputBuffer &out, std::string_view field)
+{
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        out.append(field);
+        return;
+    }
+
+    out.push('"');
+    for (char c : field)
+    {
+        if (c == '"')
+            out.push('"');
+        out.push(c);
+    }
+    out.push('"');
+}
+
+static void append_json_string(OutputBuffer &out, std::string_view text)
+{
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    out.push('"');
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        case '\r':
+            out.append("\\r");
+            break;
+        case '\t':
+            out.append("\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out.append("\\u00");
+                out.push(HEX[(c >> 4) & 0xf]);
+                out.push(HEX[c & 0xf]);
+            }
+            else
+            {
+                out.push(c);
+            }
+        }
+    }
+    out.push('"');
+}
+
+static void write_csv(OutputBuffer &out, const std::string &client_id, const WorkLogTable &logs)
+{
+    for (Calendar::Date month : logs.months())
+    {
+        for (const auto &row : logs.month(month))
+        {
+            append_csv_field(out, client_id);
+            out.push(',');
+            out.append(Calendar::iso(row.date));
+            out.push(',');
+            out.append_hours(row.hours);
+            out.push(',');
+            append_csv_field(out, row.message);
+            out.push('\n');
+        }
+    }
+}
+
+static void write_jsonl(OutputBuffer &out, const std::string &client_id, const WorkLogTable &logs)
+{
+    for (Calendar::Date month : logs.months())
+    {
+        for (const auto &row : logs.month(month))
+        {
+            out.append("{\"client\":");
+            append_json_string(out, client_id);
+            out.append(",\"date\":\"");
+            out.append(Calendar::iso(row.date));
+            out.append("\",\"hours\":");
+            out.append_hours(row.hours);
+            out.append(",\"message\":");
+            append_json_string(out, row.message);
+            out.append("}\n");
+        }
+    }
+}
+
+static void write_columnar(OutputBuffer &out, const std::string &client_id, const WorkLogTable &logs)
+{
+    // The client's pool may hold messages of overwritten rows, so each block
+    // gets its own dictionary of the messages it references.
+    MessagePool dictionary;
+    std::vector<uint32_t> message_ids;
+    message_ids.reserve(logs.size());
+    for (const auto &row : logs.all())
+        message_ids.push_back(dictionary.intern(row.message));
+
+    out.append_u32(static_cast<uint32_t>(client_id.size()));
+    out.append(client_id);
+    out.append_u32(static_cast<uint32_t>(logs.size()));
+    out.append_u32(static_cast<uint32_t>(dictionary.size()));
+
+    for (uint32_t date : logs.dates())
+        out.append_u32(date);
+    for (double hours : logs.hours())
+        out.append_f64(hours);
+    for (uint32_t id : message_ids)
+        out.append_u32(id);
+
+    for (uint32_t id = 0; id < dictionary.size(); id++)
+    {
+        std::string_view message = dictionary.get(id);
+        out.append_u32(static_cast<uint32_t>(message.size()));
+        out.append(message);
+    }
+}
+
+ExportFormat Exporter::parse_format(const std::string &name)
+{
+    if (name == "csv")
+        return ExportFormat::Csv;
+    if (name == "jsonl")
+        return ExportFormat::Jsonl;
+    if (name == "columnar")
+        return ExportFormat::Columnar;
+    throw std::runtime_error("Unknown export format: " + name + " (use csv, jsonl or columnar)");
+}
+
+size_t Exporter::write(std::ostream &out, ExportFormat format, const std::vector<std::string> &client_ids)
+{
+    std::vector<std::string> ids = client_ids.empty() ? BatchLoader::list_client_ids() : client_ids;
+
+    OutputBuffer buffer(out);
+    if (format == ExportFormat::Csv)
+        buffer.append("client,date,hours,message\n");
+    else if (format == ExportFormat::Columnar)
+        buffer.append(COLUMNAR_MAGIC);
+
+    size_t rows = 0;
+    for (const auto &client_id : ids)
+    {
+        if (!ClientManager::client_exists(client_id))
+            throw std::runtime_error("Client not found: " + client_id);
+
+        ClientData data = ClientManager::load(client_id);
+        WorkLogTable logs = std::move(data.logs);
+        if (!data.archived_months.empty())
+        {
+            WorkLogTable archived = ArchiveManager::load(client_id);
+            archived.merge(logs);
+            logs = std::move(archived);
+        }
+
+        switch (format)
+        {
+        case ExportFormat::Csv:
+            write_csv(buffer, client_id, logs);
+            break;
+        case ExportFormat::Jsonl:
+            write_jsonl(buffer, client_id, logs);
+            break;
+        case ExportFormat::Columnar:
+            write_columnar(buffer, client_id, logs);
+            break;
+        }
+        rows += logs.size();
+    }
+
+    if (format == ExportFormat::Columnar)
+        buffer.append_u32(0);
+    buffer.flush();
+    return rows;
+}
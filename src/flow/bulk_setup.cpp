@@ -0,0 +1,195 @@
+#include "flow/bulk_setup.hpp"
+#include "flow/setup.hpp"
+#include "flow/validation.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/client.hpp"
+#include "storage/config.hpp"
+#include "storage/durable_file.hpp"
+#include <map>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+// Logs and archive bookkeeping belong to the work log, not to setup.
+static const char *const CLIENT_DATA_FIELDS[] = {"logs", "archived_months"};
+
+// Overlays fields onto the current record, reporting fields it does not have.
+template <typename T>
+static bool patch(json merged, const json &fields, const std::string &where, T &result,
+                  std::vector<std::string> &problems)
+{
+    if (!fields.is_object())
+    {
+        problems.push_back(where + ": expected an object");
+        return false;
+    }
+
+    size_t before = problems.size();
+    for (const auto &[key, value] : fields.items())
+    {
+        if (!merged.contains(key))
+            problems.push_back(where + "." + key + ": unknown field");
+        else
+            merged[key] = value;
+    }
+    if (problems.size() > before)
+        return false;
+
+    try
+    {
+        result = merged.get<T>();
+        return true;
+    }
+    catch (const json::exception &e)
+    {
+        problems.push_back(where + ": " + e.what());
+        return false;
+    }
+}
+
+static void add_problems(std::vector<std::string> &problems, const std::string &where,
+                         const std::vector<std::string> &found)
+{
+    for (const auto &problem : found)
+        problems.push_back(where + "." + problem);
+}
+
+static json client_details(const ClientData &client)
+{
+    json j = client;
+    for (const char *field : CLIENT_DATA_FIELDS)
+        j.erase(field);
+    return j;
+}
+
+BulkSetupResult BulkSetup::apply(const json &manifest)
+{
+    std::vector<std::string> problems;
+    if (!manifest.is_object())
+        throw std::runtime_error("Invalid setup manifest: expected an object");
+
+    for (const auto &[key, value] : manifest.items())
+    {
+        if (key != "company" && key != "clients")
+            problems.push_back(key + ": unknown section");
+    }
+
+    bool has_config = ConfigManager::config_exists();
+    AppConfig current_config = has_config ? ConfigManager::load() : AppConfig{};
+    AppConfig config = current_config;
+    if (manifest.contains("company"))
+    {
+        if (patch(json(current_config.company), manifest["company"], "company", config.company, problems))
+        {
+            if (config.company.currency.empty())
+                config.company.currency = "EUR";
+            add_problems(problems, "company", Validation::company(config.company));
+        }
+    }
+    else if (!has_config)
+    {
+        problems.push_back("company: no business configuration yet, so this section is required");
+    }
+
+    std::map<std::string, ClientData> clients;
+    std::map<std::string, ClientData> existing;
+    if (manifest.contains("clients"))
+    {
+        const json &entries = manifest["clients"];
+        if (!entries.is_object())
+        {
+            problems.push_back("clients: expected an object keyed by client id");
+        }
+        else
+        {
+            std::vector<std::string> ids;
+            for (const auto &[id, fields] : entries.items())
+            {
+                std::string error = Validation::client_id(id);
+                if (!error.empty())
+                    problems.push_back("clients." + id + ": " + error);
+                else if (ClientManager::client_exists(id))
+                    ids.push_back(id);
+            }
+
+            // Updates have to keep each client's logs, so existing clients are loaded in one parallel pass.
+            existing = BatchLoader::load(ids);
+
+            for (const auto &[id, fields] : entries.items())
+            {
+                if (!Validation::client_id(id).empty())
+                    continue;
+
+                auto found = existing.find(id);
+                std::string where = "clients." + id;
+                ClientData &client = clients[id];
+                if (!patch(client_details(found != existing.end() ? found->second : ClientData{}), fields, where,
+                           client, problems))
+                    continue;
+
+                add_problems(problems, where, Validation::client(client));
+                if (found != existing.end())
+                {
+                    client.logs = std::move(found->second.logs);
+                    client.archived_months = std::move(found->second.archived_months);
+                }
+            }
+        }
+    }
+
+    if (!problems.empty())
+    {
+        std::string message = "Invalid setup manifest:";
+        for (const auto &problem : problems)
+            message += "\n  " + problem;
+        throw std::runtime_error(message);
+    }
+
+    BulkSetupResult result;
+    WriteBatch batch;
+
+    if (!has_config || json(config) != json(current_config))
+    {
+        if (config.company.logo_path != current_config.company.logo_path)
+            config.company.logo_path = SetupFlow::install_logo(config.company.logo_path);
+        ConfigManager::save(config);
+        result.config_saved = true;
+    }
+    ConfigManager::ensure_directories();
+
+    for (auto &[id, client] : clients)
+    {
+        auto found = existing.find(id);
+        if (found == existing.end())
+        {
+            result.created++;
+        }
+        else if (client_details(found->second) == client_details(client))
+        {
+            result.unchanged++;
+            continue;
+        }
+        else
+        {
+            result.updated++;
+        }
+        ClientManager::save(id, client);
+    }
+
+    batch.commit();
+    return result;
+}
+
+BulkSetupResult BulkSetup::apply(std::istream &in)
+{
+    json manifest;
+    try
+    {
+        manifest = json::parse(in);
+    }
+    catch (const json::parse_error &e)
+    {
+        throw std::runtime_error(std::string("Invalid setup manifest: ") + e.what());
+    }
+    return apply(manifest);
+}
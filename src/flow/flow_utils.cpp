@@ -1,4 +1,5 @@
 #include "flow/flow_utils.hpp"
+#include "flow/validation.hpp"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -22,9 +23,10 @@ namespace FlowUtils
         while (true)
         {
             std::string result = prompt(label, current);
-            if (!result.empty())
+            std::string error = Validation::required(result);
+            if (error.empty())
                 return result;
-            std::cout << "This field is required." << std::endl;
+            std::cout << error << std::endl;
         }
     }
 
@@ -44,17 +46,11 @@ namespace FlowUtils
             if (input.empty() && current > 0)
                 return current;
 
-            try
-            {
-                double value = std::stod(input);
-                if (value > 0)
-                    return value;
-                std::cout << "Please enter a positive number." << std::endl;
-            }
-            catch (...)
-            {
-                std::cout << "Invalid number. Please try again." << std::endl;
-            }
+            double value = 0.0;
+            std::string error = Validation::positive_number(input, value);
+            if (error.empty())
+                return value;
+            std::cout << error << std::endl;
         }
     }
 
@@ -68,17 +64,11 @@ namespace FlowUtils
             if (input.empty() && current > 0)
                 return current;
 
-            try
-            {
-                int value = std::stoi(input);
-                if (value > 0)
-                    return value;
-                std::cout << "Please enter a positive number." << std::endl;
-            }
-            catch (...)
-            {
-                std::cout << "Invalid number. Please try again." << std::endl;
-            }
+            int value = 0;
+            std::string error = Validation::positive_integer(input, value);
+            if (error.empty())
+                return value;
+            std::cout << error << std::endl;
         }
     }
 
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include "flow/setup.hpp"
 #include "flow/flow_utils.hpp"
+#include "flow/validation.hpp"
 #include "storage/config.hpp"
 
 namespace fs = std::filesystem;
@@ -31,6 +32,20 @@ static std::string clean_path(const std::string &path)
     return strip_quotes(trim(path));
 }
 
+std::string SetupFlow::install_logo(const std::string &path)
+{
+    std::string logos_dir = ConfigManager::get_logos_dir();
+    fs::create_directories(logos_dir);
+
+    fs::path source(path);
+    fs::path dest = fs::path(logos_dir) / ("logo" + source.extension().string());
+    if (fs::exists(dest) && fs::equivalent(source, dest))
+        return dest.string();
+
+    fs::copy_file(source, dest, fs::copy_options::overwrite_existing);
+    return dest.string();
+}
+
 static std::string prompt_logo_path(const std::string &current)
 {
     while (true)
@@ -40,23 +55,18 @@ static std::string prompt_logo_path(const std::string &current)
         if (input == current && !current.empty() && fs::exists(current))
             return current;
 
-        if (!fs::exists(input))
+        std::string error = Validation::logo_path(input);
+        if (!error.empty())
         {
-            std::cout << "File not found: " << input << std::endl;
+            std::cout << error << std::endl;
             continue;
         }
 
-        std::string logos_dir = ConfigManager::get_logos_dir();
-        fs::create_directories(logos_dir);
-
-        fs::path source(input);
-        fs::path dest = fs::path(logos_dir) / ("logo" + source.extension().string());
-
         try
         {
-            fs::copy_file(source, dest, fs::copy_options::overwrite_existing);
-            std::cout << "Logo copied to " << dest.string() << std::endl;
-            return dest.string();
+            std::string dest = SetupFlow::install_logo(input);
+            std::cout << "Logo copied to " << dest << std::endl;
+            return dest;
         }
         catch (const fs::filesystem_error &e)
         {
@@ -0,0 +1,107 @@
+#include "flow/validation.hpp"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace Validation
+{
+    std::string required(const std::string &value)
+    {
+        return value.empty() ? "This field is required." : "";
+    }
+
+    std::string positive_number(const std::string &text, double &value)
+    {
+        try
+        {
+            size_t used = 0;
+            double parsed = std::stod(text, &used);
+            if (used != text.size())
+                return "Invalid number. Please try again.";
+            if (parsed <= 0)
+                return "Please enter a positive number.";
+            value = parsed;
+            return "";
+        }
+        catch (...)
+        {
+            return "Invalid number. Please try again.";
+        }
+    }
+
+    std::string positive_integer(const std::string &text, int &value)
+    {
+        try
+        {
+            size_t used = 0;
+            int parsed = std::stoi(text, &used);
+            if (used != text.size())
+                return "Invalid number. Please try again.";
+            if (parsed <= 0)
+                return "Please enter a positive number.";
+            value = parsed;
+            return "";
+        }
+        catch (...)
+        {
+            return "Invalid number. Please try again.";
+        }
+    }
+
+    std::string client_id(const std::string &id)
+    {
+        if (id.empty())
+            return "Client id is required.";
+        for (char c : id)
+        {
+            bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                           c == '-' || c == '_' || c == '.';
+            if (!allowed)
+                return "Client id may only contain letters, digits, '-', '_' and '.'.";
+        }
+        if (id.front() == '.')
+            return "Client id may not start with '.'.";
+        return "";
+    }
+
+    std::string logo_path(const std::string &path)
+    {
+        if (path.empty())
+            return required(path);
+        return fs::exists(path) ? "" : "File not found: " + path;
+    }
+
+    static void check(std::vector<std::string> &problems, const std::string &field, const std::string &message)
+    {
+        if (!message.empty())
+            problems.push_back(field + ": " + message);
+    }
+
+    std::vector<std::string> company(const CompanyConfig &company)
+    {
+        std::vector<std::string> problems;
+        check(problems, "name", required(company.name));
+        check(problems, "address_line1", required(company.address_line1));
+        check(problems, "address_line2", required(company.address_line2));
+        check(problems, "kvk", required(company.kvk));
+        check(problems, "btw", required(company.btw));
+        check(problems, "bank_account", required(company.bank_account));
+        check(problems, "tag", required(company.tag));
+        check(problems, "logo_path", logo_path(company.logo_path));
+        return problems;
+    }
+
+    std::vector<std::string> client(const ClientData &client)
+    {
+        std::vector<std::string> problems;
+        check(problems, "name", required(client.name));
+        check(problems, "address_line1", required(client.address_line1));
+        check(problems, "address_line2", required(client.address_line2));
+        if (client.hourly_rate <= 0)
+            check(problems, "hourly_rate", "Please enter a positive number.");
+        if (client.payment_term_days <= 0)
+            check(problems, "payment_term_days", "Please enter a positive number.");
+        check(problems, "tag", required(client.tag));
+        return problems;
+    }
+}
@@ -1,20 +1,27 @@
 #include "invoice/generator.hpp"
+#include "pipeline/pipeline.hpp"
 #include "billing/constants.hpp"
 #include "storage/config.hpp"
 #include "storage/client.hpp"
-#include <chrono>
+#include "storage/batch_loader.hpp"
 #include <iomanip>
 #include <sstream>
 #include <cmath>
-#include <filesystem>
-#include <iostream>
+#include <memory>
+#include <mutex>
+
+using namespace InvoiceLayout;
+
+// Every invoice of a company shares its template, so bulk runs build it once.
+static std::mutex template_mutex;
+static std::shared_ptr<const InvoiceTemplate> cached_template;
 
 static void error_handler(HPDF_STATUS error_no, HPDF_STATUS detail_no, void *)
 {
     throw std::runtime_error("PDF error: " + std::to_string(error_no) + ", detail: " + std::to_string(detail_no));
 }
 
-PDFBuilder::PDFBuilder(const InvoiceData &data) : data_(data)
+PDFBuilder::PDFBuilder(const InvoiceData &data, const InvoiceTemplate &layout) : data_(data), layout_(layout)
 {
     pdf_ = HPDF_New(error_handler, nullptr);
     if (!pdf_)
@@ -35,12 +42,14 @@ PDFBuilder::~PDFBuilder()
 
 void PDFBuilder::build()
 {
-    draw_header();
-    draw_company_info();
-    draw_date_info();
+    layout_.replay(pdf_, page_, font_, font_bold_);
+
+    draw_invoice_number();
+    draw_dates();
+    draw_balance_due();
     draw_billed_to();
-    float table_end_y = draw_table();
-    draw_footer(table_end_y - 40);
+    draw_amounts();
+    draw_terms();
 }
 
 void PDFBuilder::save(const std::string &path)
@@ -65,278 +74,106 @@ void PDFBuilder::set_color(float gray)
     HPDF_Page_SetRGBFill(page_, gray, gray, gray);
 }
 
-void PDFBuilder::set_color(float r, float g, float b)
-{
-    HPDF_Page_SetRGBFill(page_, r, g, b);
-}
-
-void PDFBuilder::draw_header()
-{
-    draw_logo();
-    draw_invoice_title();
-}
-
-void PDFBuilder::draw_logo()
+void PDFBuilder::draw_invoice_number()
 {
-    if (data_.company_logo.empty() || !std::filesystem::exists(data_.company_logo))
-        return;
-
-    std::string ext = std::filesystem::path(data_.company_logo).extension().string();
-    HPDF_Image logo = nullptr;
-
-    HPDF_SetErrorHandler(pdf_, nullptr);
-    if (ext == ".jpg" || ext == ".jpeg" || ext == ".JPG" || ext == ".JPEG")
-        logo = HPDF_LoadJpegImageFromFile(pdf_, data_.company_logo.c_str());
-    HPDF_SetErrorHandler(pdf_, error_handler);
-    HPDF_ResetError(pdf_);
-
-    if (logo)
-    {
-        float w = HPDF_Image_GetWidth(logo);
-        float h = HPDF_Image_GetHeight(logo);
-        float scale = std::min(150.0f / w, 80.0f / h);
-        float logo_top = PAGE_HEIGHT - MARGIN + 20.0f;
-        HPDF_Page_DrawImage(page_, logo, MARGIN, logo_top - h * scale, w * scale, h * scale);
-    }
-    else
-    {
-        std::cerr << "Warning: Could not load logo. Only JPEG format is supported." << std::endl;
-    }
-}
-
-void PDFBuilder::draw_invoice_title()
-{
-    float y = PAGE_HEIGHT - MARGIN;
-    set_font(true, 28);
-    text(PAGE_WIDTH - MARGIN - 100, y, "INVOICE");
-
     set_font(false, 10);
     set_color(0.5f);
-    text(PAGE_WIDTH - MARGIN - 85, y - 22, "# " + data_.invoice_number);
+    text(PAGE_WIDTH - MARGIN - 85, TITLE_Y - 22, "# " + data_.invoice_number);
 }
 
-void PDFBuilder::draw_company_info()
+void PDFBuilder::draw_dates()
 {
-    float y = PAGE_HEIGHT - MARGIN - 100;
-
     set_color(0);
-    set_font(true, 11);
-    text(MARGIN, y, data_.company_name);
-
-    set_font(false, 10);
-    text(MARGIN, y - 15, data_.company_address1);
-    text(MARGIN, y - 29, data_.company_address2);
-}
-
-void PDFBuilder::draw_date_info()
-{
-    float lx = 360, vx = 480;
-    float y = PAGE_HEIGHT - MARGIN - 100;
-
-    auto row = [&](const std::string &label, const std::string &value) {
-        set_color(0.4f);
-        text(lx, y, label);
-        set_color(0);
-        text(vx, y, value);
-        y -= 18;
-    };
-
-    set_font(false, 10);
-    row("Date:", format_date(data_.date));
-    row("Payment Terms:", std::to_string(data_.payment_term_days) + " Days");
-    row("Due Date:", format_date(data_.due_date));
-
-    draw_balance_due_box();
+    HPDF_Page_BeginText(page_);
+    HPDF_Page_TextOut(page_, VALUE_X, INFO_Y, format_date(data_.date).c_str());
+    HPDF_Page_TextOut(page_, VALUE_X, INFO_Y - LINE, (std::to_string(data_.payment_term_days) + " Days").c_str());
+    HPDF_Page_TextOut(page_, VALUE_X, INFO_Y - 2 * LINE, format_date(data_.due_date).c_str());
+    HPDF_Page_EndText(page_);
 }
 
-void PDFBuilder::draw_balance_due_box()
+void PDFBuilder::draw_balance_due()
 {
-    float x = 360, vx = 480;
-    float y = PAGE_HEIGHT - MARGIN - 100 - 54 - 7;
-
-    set_color(0.98f, 0.85f, 0.5f);
-    draw_rounded_rect(x - 5, y - 7, PAGE_WIDTH - MARGIN - x + 5, 22, 5);
-
-    set_color(0);
     set_font(true, 12);
-    HPDF_Page_BeginText(page_);
-    HPDF_Page_TextOut(page_, x, y, "Balance Due:");
-    HPDF_Page_TextOut(page_, vx, y, format_currency(data_.total).c_str());
-    HPDF_Page_EndText(page_);
+    text(VALUE_X, BALANCE_Y, layout_.format_currency(data_.total));
 }
 
 void PDFBuilder::draw_billed_to()
 {
-    float y = PAGE_HEIGHT - MARGIN - 169;
-
-    set_font(false, 9);
-    set_color(0.5f);
-    text(MARGIN, y, "Billed To:");
-
-    set_color(0);
     set_font(true, 10);
-    text(MARGIN, y - 15, data_.client_name);
+    text(MARGIN, BILLED_TO_Y - 15, data_.client_name);
 
     set_font(false, 10);
-    text(MARGIN, y - 29, data_.client_address1);
-    text(MARGIN, y - 43, data_.client_address2);
-}
-
-float PDFBuilder::draw_table()
-{
-    float y = PAGE_HEIGHT - MARGIN - 252;
-    draw_table_header(y);
-    draw_table_row(y - 28);
-    return draw_totals(y - 73);
-}
-
-void PDFBuilder::draw_table_header(float y)
-{
-    set_color(0.95f, 0.6f, 0.1f);
-    draw_rounded_rect(MARGIN, y - 8, PAGE_WIDTH - 2 * MARGIN, 28, 5);
-
-    set_color(1, 1, 1);
-    set_font(true, 10);
     HPDF_Page_BeginText(page_);
-    HPDF_Page_TextOut(page_, MARGIN + 15, y + 2, "Item");
-    HPDF_Page_TextOut(page_, 280, y + 2, "Quantity");
-    HPDF_Page_TextOut(page_, 380, y + 2, "Rate");
-    HPDF_Page_TextOut(page_, 480, y + 2, "Amount");
+    HPDF_Page_TextOut(page_, MARGIN, BILLED_TO_Y - 29, data_.client_address1.c_str());
+    HPDF_Page_TextOut(page_, MARGIN, BILLED_TO_Y - 43, data_.client_address2.c_str());
     HPDF_Page_EndText(page_);
 }
 
-void PDFBuilder::draw_table_row(float y)
+void PDFBuilder::draw_amounts()
 {
-    set_color(0);
-    set_font(true, 10);
-    text(MARGIN + 15, y, "Hours");
-
-    set_font(false, 10);
     std::ostringstream hours;
     hours << std::fixed << std::setprecision(0) << data_.total_hours;
+    std::string subtotal = layout_.format_currency(data_.subtotal);
 
     HPDF_Page_BeginText(page_);
-    HPDF_Page_TextOut(page_, 280, y, hours.str().c_str());
-    HPDF_Page_TextOut(page_, 380, y, format_currency(data_.hourly_rate).c_str());
-    HPDF_Page_TextOut(page_, 480, y, format_currency(data_.subtotal).c_str());
+    HPDF_Page_TextOut(page_, QUANTITY_X, ROW_Y, hours.str().c_str());
+    HPDF_Page_TextOut(page_, RATE_X, ROW_Y, layout_.format_currency(data_.hourly_rate).c_str());
+    HPDF_Page_TextOut(page_, VALUE_X, ROW_Y, subtotal.c_str());
+    HPDF_Page_TextOut(page_, VALUE_X, TOTALS_Y, subtotal.c_str());
+    HPDF_Page_TextOut(page_, VALUE_X, TOTALS_Y - LINE, layout_.format_currency(data_.vat).c_str());
     HPDF_Page_EndText(page_);
-}
-
-float PDFBuilder::draw_totals(float y)
-{
-    set_font(false, 10);
 
-    auto row = [&](const std::string &label, double amount, bool bold = false) {
-        if (bold) set_font(true, 10);
-        HPDF_Page_BeginText(page_);
-        HPDF_Page_TextOut(page_, 380, y, label.c_str());
-        HPDF_Page_TextOut(page_, 480, y, format_currency(amount).c_str());
-        HPDF_Page_EndText(page_);
-        y -= 18;
-    };
-
-    row("Subtotal:", data_.subtotal);
-    row("VAT (21%):", data_.vat);
-    row("Total:", data_.total, true);
-
-    return y + 18;
+    set_font(true, 10);
+    text(VALUE_X, TOTALS_Y - 2 * LINE, layout_.format_currency(data_.total));
 }
 
-void PDFBuilder::draw_footer(float y)
+void PDFBuilder::draw_terms()
 {
-    set_font(false, 9);
-    set_color(0.5f);
-    text(MARGIN, y, "Details:");
-
-    set_color(0);
-    set_font(false, 10);
-    text(MARGIN, y - 15, "KvK: " + data_.company_kvk);
-    text(MARGIN, y - 29, "BTW: " + data_.company_btw);
-    text(MARGIN, y - 43, "Bank Account: " + data_.company_bank);
-
-    set_font(false, 9);
-    set_color(0.5f);
-    text(MARGIN, y - 68, "Terms:");
-
-    set_color(0);
     set_font(false, 10);
     std::ostringstream terms;
     terms << "Please pay the total amount within " << data_.payment_term_days
           << " days to the IBAN bank account number, stating the invoice number.";
-    text(MARGIN, y - 83, terms.str());
-}
-
-void PDFBuilder::draw_rounded_rect(float x, float y, float w, float h, float r)
-{
-    HPDF_Page_MoveTo(page_, x + r, y);
-    HPDF_Page_LineTo(page_, x + w - r, y);
-    HPDF_Page_CurveTo(page_, x + w, y, x + w, y, x + w, y + r);
-    HPDF_Page_LineTo(page_, x + w, y + h - r);
-    HPDF_Page_CurveTo(page_, x + w, y + h, x + w, y + h, x + w - r, y + h);
-    HPDF_Page_LineTo(page_, x + r, y + h);
-    HPDF_Page_CurveTo(page_, x, y + h, x, y + h, x, y + h - r);
-    HPDF_Page_LineTo(page_, x, y + r);
-    HPDF_Page_CurveTo(page_, x, y, x, y, x + r, y);
-    HPDF_Page_Fill(page_);
-}
-
-std::string PDFBuilder::format_currency(double amount)
-{
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
-
-    if (data_.currency == "EUR")
-        oss << "\x80 " << amount;
-    else if (data_.currency == "USD")
-        oss << "$ " << amount;
-    else if (data_.currency == "GBP")
-        oss << "\xA3 " << amount;
-    else
-        oss << data_.currency << " " << amount;
-
-    return oss.str();
+    text(MARGIN, FOOTER_Y - 83, terms.str());
 }
 
-std::string PDFBuilder::format_date(const std::string &date)
+Calendar::Text PDFBuilder::format_date(std::string_view date)
 {
-    std::tm tm = {};
-    std::istringstream ss(date);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%b %d, %Y");
-    return oss.str();
+    Calendar::Date parsed = Calendar::parse_date(date);
+    if (!parsed.valid())
+    {
+        Calendar::Text text;
+        text.append(date);
+        return text;
+    }
+    return Calendar::long_date(parsed);
 }
 
 InvoiceData InvoiceGenerator::prepare_data(const std::string &client_id, const std::string &month)
 {
     AppConfig config = ConfigManager::load();
-    ClientData client = ClientManager::load(client_id);
-
     std::string month_key = month.empty() ? ClientManager::get_previous_month_key() : month;
-    double total_hours = ClientManager::get_month_total_hours(client, month_key);
+    // An invoice only needs the month's total, so no rows are materialized.
+    Pipeline::Source source = Pipeline::Source::month(client_id, month_key);
+    Pipeline::Summary summary = source.totals();
 
+    return prepare_data(config, source.client(), month_key, summary.hours);
+}
+
+InvoiceData InvoiceGenerator::prepare_data(const AppConfig &config, const ClientData &client,
+                                           const std::string &month_key, double total_hours)
+{
     if (total_hours <= 0)
         throw std::runtime_error("No hours logged for " + month_key);
 
-    auto now = std::chrono::system_clock::now();
-    auto now_time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&now_time);
-
-    std::ostringstream date_ss;
-    date_ss << std::put_time(&tm, "%Y-%m-%d");
-
-    tm.tm_mday += client.payment_term_days;
-    std::mktime(&tm);
-
-    std::ostringstream due_ss;
-    due_ss << std::put_time(&tm, "%Y-%m-%d");
+    Calendar::Date today = Calendar::today();
+    Calendar::Date due = Calendar::due_date(today, client.payment_term_days);
 
     Billing::AmountBreakdown amounts = Billing::calculate_amounts(total_hours, client.hourly_rate);
 
     InvoiceData data;
     data.invoice_number = config.company.tag + "-" + client.tag + "-" + month_key;
-    data.date = date_ss.str();
-    data.due_date = due_ss.str();
+    data.date = Calendar::iso(today).str();
+    data.due_date = Calendar::iso(due).str();
     data.payment_term_days = client.payment_term_days;
 
     data.company_name = config.company.name;
@@ -361,17 +198,47 @@ InvoiceData InvoiceGenerator::prepare_data(const std::string &client_id, const s
     return data;
 }
 
-std::string InvoiceGenerator::generate(const std::string &client_id, const std::string &month)
+std::string InvoiceGenerator::save(const InvoiceData &data)
 {
-    if (!ClientManager::client_exists(client_id))
-        throw std::runtime_error("Client not found: " + client_id);
-
-    InvoiceData data = prepare_data(client_id, month);
     std::string output_path = data.invoice_number + ".pdf";
 
-    PDFBuilder builder(data);
+    std::shared_ptr<const InvoiceTemplate> layout;
+    {
+        std::lock_guard<std::mutex> lock(template_mutex);
+        if (!cached_template || !cached_template->matches(data))
+            cached_template = std::make_shared<const InvoiceTemplate>(data);
+        layout = cached_template;
+    }
+
+    PDFBuilder builder(data, *layout);
     builder.build();
     builder.save(output_path);
 
     return output_path;
 }
+
+std::string InvoiceGenerator::generate(const std::string &client_id, const std::string &month)
+{
+    if (!ClientManager::client_exists(client_id))
+        throw std::runtime_error("Client not found: " + client_id);
+
+    return save(prepare_data(client_id, month));
+}
+
+std::vector<std::string> InvoiceGenerator::generate_all(const std::string &month)
+{
+    AppConfig config = ConfigManager::load();
+    std::string month_key = month.empty() ? ClientManager::get_previous_month_key() : month;
+
+    std::vector<std::string> outputs;
+    for (const auto &client_id : BatchLoader::list_client_ids())
+    {
+        Pipeline::Source source = Pipeline::Source::month(client_id, month_key);
+        Pipeline::Summary summary = source.totals();
+        if (summary.hours <= 0)
+            continue;
+
+        outputs.push_back(save(prepare_data(config, source.client(), month_key, summary.hours)));
+    }
+    return outputs;
+}
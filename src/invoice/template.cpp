@@ -0,0 +1,241 @@
+#include "invoice/template.hpp"
+#include "invoice/generator.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+using namespace InvoiceLayout;
+
+// Every field the template is drawn from, in one string.
+static std::string company_key(const InvoiceData &data)
+{
+    std::string key;
+    for (const std::string *field : {&data.company_name, &data.company_address1, &data.company_address2,
+                                     &data.company_kvk, &data.company_btw, &data.company_bank,
+                                     &data.company_logo, &data.currency})
+    {
+        key.append(*field);
+        key.push_back('\0');
+    }
+    return key;
+}
+
+InvoiceTemplate::InvoiceTemplate(const InvoiceData &data) : company_(company_key(data))
+{
+    if (data.currency == "EUR")
+        currency_prefix_ = "\x80 ";
+    else if (data.currency == "USD")
+        currency_prefix_ = "$ ";
+    else if (data.currency == "GBP")
+        currency_prefix_ = "\xA3 ";
+    else
+        currency_prefix_ = data.currency + " ";
+
+    load_logo(data.company_logo);
+
+    set_font(true, 28);
+    text(PAGE_WIDTH - MARGIN - 100, TITLE_Y, "INVOICE");
+
+    set_color(0);
+    set_font(true, 11);
+    text(MARGIN, INFO_Y, data.company_name);
+    set_font(false, 10);
+    text(MARGIN, INFO_Y - 15, data.company_address1);
+    text(MARGIN, INFO_Y - 29, data.company_address2);
+
+    set_color(0.4f);
+    text(LABEL_X, INFO_Y, "Date:");
+    text(LABEL_X, INFO_Y - LINE, "Payment Terms:");
+    text(LABEL_X, INFO_Y - 2 * LINE, "Due Date:");
+
+    set_color(0.98f, 0.85f, 0.5f);
+    rounded_rect(LABEL_X - 5, BALANCE_Y - 7, PAGE_WIDTH - MARGIN - LABEL_X + 5, 22, 5);
+    set_color(0);
+    set_font(true, 12);
+    text(LABEL_X, BALANCE_Y, "Balance Due:");
+
+    set_font(false, 9);
+    set_color(0.5f);
+    text(MARGIN, BILLED_TO_Y, "Billed To:");
+
+    set_color(0.95f, 0.6f, 0.1f);
+    rounded_rect(MARGIN, TABLE_Y - 8, PAGE_WIDTH - 2 * MARGIN, 28, 5);
+    set_color(1);
+    set_font(true, 10);
+    text(MARGIN + 15, TABLE_Y + 2, "Item");
+    text(QUANTITY_X, TABLE_Y + 2, "Quantity");
+    text(RATE_X, TABLE_Y + 2, "Rate");
+    text(VALUE_X, TABLE_Y + 2, "Amount");
+
+    set_color(0);
+    text(MARGIN + 15, ROW_Y, "Hours");
+
+    set_font(false, 10);
+    text(RATE_X, TOTALS_Y, "Subtotal:");
+    text(RATE_X, TOTALS_Y - LINE, "VAT (21%):");
+    set_font(true, 10);
+    text(RATE_X, TOTALS_Y - 2 * LINE, "Total:");
+
+    set_font(false, 9);
+    set_color(0.5f);
+    text(MARGIN, FOOTER_Y, "Details:");
+    text(MARGIN, FOOTER_Y - 68, "Terms:");
+    set_color(0);
+    set_font(false, 10);
+    text(MARGIN, FOOTER_Y - 15, "KvK: " + data.company_kvk);
+    text(MARGIN, FOOTER_Y - 29, "BTW: " + data.company_btw);
+    text(MARGIN, FOOTER_Y - 43, "Bank Account: " + data.company_bank);
+}
+
+bool InvoiceTemplate::matches(const InvoiceData &data) const
+{
+    return company_key(data) == company_;
+}
+
+void InvoiceTemplate::replay(HPDF_Doc pdf, HPDF_Page page, HPDF_Font font, HPDF_Font font_bold) const
+{
+    if (!logo_.empty())
+    {
+        HPDF_Image logo = HPDF_LoadJpegImageFromMem(pdf, reinterpret_cast<const HPDF_BYTE *>(logo_.data()),
+                                                    static_cast<HPDF_UINT>(logo_.size()));
+        float w = HPDF_Image_GetWidth(logo);
+        float h = HPDF_Image_GetHeight(logo);
+        float scale = std::min(150.0f / w, 80.0f / h);
+        float logo_top = PAGE_HEIGHT - MARGIN + 20.0f;
+        HPDF_Page_DrawImage(page, logo, MARGIN, logo_top - h * scale, w * scale, h * scale);
+    }
+
+    // Runs of text share one text object; shapes can't be drawn inside one.
+    bool in_text = false;
+    for (const Command &command : commands_)
+    {
+        switch (command.kind)
+        {
+        case Command::Kind::Font:
+            HPDF_Page_SetFontAndSize(page, command.bold ? font_bold : font, command.size);
+            break;
+        case Command::Kind::Fill:
+            HPDF_Page_SetRGBFill(page, command.red, command.green, command.blue);
+            break;
+        case Command::Kind::Text:
+            if (!in_text)
+                HPDF_Page_BeginText(page);
+            in_text = true;
+            HPDF_Page_TextOut(page, command.x, command.y, command.text.c_str());
+            break;
+        case Command::Kind::RoundedRect:
+        {
+            if (in_text)
+                HPDF_Page_EndText(page);
+            in_text = false;
+
+            float x = command.x, y = command.y, w = command.width, h = command.height, r = command.radius;
+            HPDF_Page_MoveTo(page, x + r, y);
+            HPDF_Page_LineTo(page, x + w - r, y);
+            HPDF_Page_CurveTo(page, x + w, y, x + w, y, x + w, y + r);
+            HPDF_Page_LineTo(page, x + w, y + h - r);
+            HPDF_Page_CurveTo(page, x + w, y + h, x + w, y + h, x + w - r, y + h);
+            HPDF_Page_LineTo(page, x + r, y + h);
+            HPDF_Page_CurveTo(page, x, y + h, x, y + h, x, y + h - r);
+            HPDF_Page_LineTo(page, x, y + r);
+            HPDF_Page_CurveTo(page, x, y, x, y, x + r, y);
+            HPDF_Page_Fill(page);
+            break;
+        }
+        }
+    }
+    if (in_text)
+        HPDF_Page_EndText(page);
+}
+
+std::string InvoiceTemplate::format_currency(double amount) const
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << currency_prefix_ << amount;
+    return oss.str();
+}
+
+void InvoiceTemplate::set_font(bool bold, float size)
+{
+    if (bold == bold_ && size == size_)
+        return;
+    bold_ = bold;
+    size_ = size;
+
+    Command command;
+    command.kind = Command::Kind::Font;
+    command.bold = bold;
+    command.size = size;
+    commands_.push_back(std::move(command));
+}
+
+void InvoiceTemplate::set_color(float red, float green, float blue)
+{
+    if (red == red_ && green == green_ && blue == blue_)
+        return;
+    red_ = red;
+    green_ = green;
+    blue_ = blue;
+
+    Command command;
+    command.kind = Command::Kind::Fill;
+    command.red = red;
+    command.green = green;
+    command.blue = blue;
+    commands_.push_back(std::move(command));
+}
+
+void InvoiceTemplate::text(float x, float y, std::string text)
+{
+    Command command;
+    command.kind = Command::Kind::Text;
+    command.x = x;
+    command.y = y;
+    command.text = std::move(text);
+    commands_.push_back(std::move(command));
+}
+
+void InvoiceTemplate::rounded_rect(float x, float y, float width, float height, float radius)
+{
+    Command command;
+    command.kind = Command::Kind::RoundedRect;
+    command.x = x;
+    command.y = y;
+    command.width = width;
+    command.height = height;
+    command.radius = radius;
+    commands_.push_back(std::move(command));
+}
+
+// The file is read once here and decoded into each document from memory.
+void InvoiceTemplate::load_logo(const std::string &path)
+{
+    if (path.empty() || !std::filesystem::exists(path))
+        return;
+
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::ifstream file(path, std::ios::binary);
+    bool jpeg = (ext == ".jpg" || ext == ".jpeg" || ext == ".JPG" || ext == ".JPEG") && file;
+    if (jpeg)
+        logo_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    // Reject what libharu would fail on, so replay() never has to.
+    HPDF_Doc probe = jpeg && !logo_.empty() ? HPDF_New(nullptr, nullptr) : nullptr;
+    HPDF_Image image = nullptr;
+    if (probe)
+    {
+        image = HPDF_LoadJpegImageFromMem(probe, reinterpret_cast<const HPDF_BYTE *>(logo_.data()),
+                                          static_cast<HPDF_UINT>(logo_.size()));
+        HPDF_Free(probe);
+    }
+
+    if (!image)
+    {
+        logo_.clear();
+        std::cerr << "Warning: Could not load logo. Only JPEG format is supported." << std::endl;
+    }
+}
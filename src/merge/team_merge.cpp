@@ -0,0 +1,181 @@
+#include "merge/team_merge.hpp"
+#include "storage/config.hpp"
+#include "storage/data_root.hpp"
+#include "report/work_log.hpp"
+#include "invoice/generator.hpp"
+#include "billing/constants.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+// One root's month of the client, copied out of its storage so the loaded
+// file can be dropped before the next root is read.
+struct RootMonth
+{
+    std::vector<Calendar::Date> dates;
+    std::vector<double> hours;
+    std::vector<uint32_t> message_ends;
+    std::string text;
+
+    size_t size() const { return dates.size(); }
+
+    std::string_view message(size_t i) const
+    {
+        uint32_t begin = i == 0 ? 0 : message_ends[i - 1];
+        return std::string_view(text).substr(begin, message_ends[i] - begin);
+    }
+};
+
+MergeSource TeamMerge::parse_source(const std::string &spec)
+{
+    MergeSource root;
+    size_t equals = spec.find('=');
+    root.dir = equals == std::string::npos ? spec : spec.substr(equals + 1);
+    if (equals != std::string::npos)
+        root.author = spec.substr(0, equals);
+
+    if (root.dir.empty())
+        throw std::runtime_error("Missing directory in --merge " + spec);
+    if (!fs::is_directory(fs::path(root.dir) / "clients"))
+        throw std::runtime_error("Not a wlog data directory: " + root.dir);
+
+    if (root.author.empty())
+    {
+        fs::path path = fs::path(root.dir).lexically_normal();
+        if (!path.has_filename())
+            path = path.parent_path();
+        root.author = path.filename() == ".wlog" ? path.parent_path().filename().string()
+                                                 : path.filename().string();
+    }
+    return root;
+}
+
+ClientData TeamMerge::merge_month(const std::vector<MergeSource> &roots, const std::string &client_id,
+                                  const std::string &month_key, const MergeSink &sink)
+{
+    std::vector<RootMonth> months(roots.size());
+    ClientData details;
+    bool found = false;
+
+    for (size_t i = 0; i < roots.size(); i++)
+    {
+        DataRoot root(roots[i].dir);
+        DataRoot::Scope scope(&root);
+        if (!ClientManager::client_exists(client_id))
+            continue;
+
+        ClientData client = ClientManager::load(client_id, month_key);
+        RootMonth &month = months[i];
+        for (const auto &row : client.logs.month(month_key))
+        {
+            month.dates.push_back(row.date);
+            month.hours.push_back(row.hours);
+            month.text.append(row.message);
+            month.message_ends.push_back(static_cast<uint32_t>(month.text.size()));
+        }
+
+        if (!found)
+        {
+            client.logs = WorkLogTable();
+            client.archived_months.clear();
+            details = std::move(client);
+            found = true;
+        }
+    }
+
+    if (!found)
+        throw std::runtime_error("Client not found in any merged directory: " + client_id);
+
+    // Heads of each root's list, keyed by date and then root index.
+    using Head = std::pair<uint64_t, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    std::vector<size_t> positions(roots.size(), 0);
+
+    auto push_head = [&](size_t root)
+    {
+        if (positions[root] < months[root].size())
+        {
+            uint64_t key = static_cast<uint64_t>(months[root].dates[positions[root]].value) << 32 | root;
+            heads.push({key, root});
+        }
+    };
+
+    for (size_t i = 0; i < roots.size(); i++)
+        push_head(i);
+
+    while (!heads.empty())
+    {
+        size_t root = heads.top().second;
+        heads.pop();
+
+        size_t pos = positions[root]++;
+        MergedEntry entry;
+        entry.date = months[root].dates[pos];
+        entry.hours = months[root].hours[pos];
+        entry.author = &roots[root].author;
+        entry.message = months[root].message(pos);
+        sink(entry);
+
+        push_head(root);
+    }
+
+    return details;
+}
+
+static std::string resolve_month(const std::string &month)
+{
+    return month.empty() ? ClientManager::get_previous_month_key() : month;
+}
+
+std::string TeamMerge::generate_report(const std::vector<MergeSource> &roots, const std::string &client_id,
+                                       const std::string &month, ReportFormat format)
+{
+    AppConfig config = ConfigManager::load();
+    std::string month_key = resolve_month(month);
+
+    WorkLogReportData data;
+    ClientData client = merge_month(roots, client_id, month_key, [&](const MergedEntry &merged)
+    {
+        WorkLogEntry entry;
+        entry.date = Calendar::iso(merged.date);
+        entry.hours = merged.hours;
+        entry.message = *merged.author;
+        entry.message += ": ";
+        entry.message += merged.message;
+        data.entries.push_back(std::move(entry));
+    });
+
+    data.client_name = client.name;
+    data.month = month_key;
+    data.currency = config.company.currency;
+    data.hourly_rate = client.hourly_rate;
+    data.total_hours = 0;
+    for (const auto &entry : data.entries)
+        data.total_hours += entry.hours;
+
+    Billing::AmountBreakdown amounts = Billing::calculate_amounts(data.total_hours, data.hourly_rate);
+    data.subtotal = amounts.subtotal;
+    data.vat = amounts.vat;
+    data.total = amounts.total;
+
+    return WorkLogReport::save(client_id, data, format);
+}
+
+std::string TeamMerge::generate_invoice(const std::vector<MergeSource> &roots, const std::string &client_id,
+                                        const std::string &month)
+{
+    AppConfig config = ConfigManager::load();
+    std::string month_key = resolve_month(month);
+
+    double total_hours = 0.0;
+    ClientData client = merge_month(roots, client_id, month_key, [&](const MergedEntry &entry)
+    {
+        total_hours += entry.hours;
+    });
+
+    return InvoiceGenerator::save(InvoiceGenerator::prepare_data(config, client, month_key, total_hours));
+}
@@ -0,0 +1,74 @@
+#include "pipeline/pipeline.hpp"
+
+namespace Pipeline
+{
+    Source::Source(std::string client_id, Calendar::Date from, Calendar::Date to)
+        : client_id_(std::move(client_id)), from_(from), to_(to)
+    {
+    }
+
+    Source Source::month(const std::string &client_id, const std::string &month_key)
+    {
+        Calendar::Date month = Calendar::parse_month(month_key);
+        return Source(client_id, month.month_start(), month.month_end());
+    }
+
+    Source &Source::filter(Filter keep)
+    {
+        filters_.push_back(std::move(keep));
+        return *this;
+    }
+
+    Summary Source::run(Sink &sink)
+    {
+        client_ = ClientManager::load(client_id_, from_, to_);
+        sink.begin(client_);
+
+        Summary summary;
+        WorkLogTable::Range rows = client_.logs.between(from_, to_);
+        if (filters_.empty() && !sink.needs_rows())
+        {
+            summary.entries = rows.size();
+            summary.hours = rows.total_hours();
+        }
+        else
+        {
+            bool needs_rows = sink.needs_rows();
+            for (const auto &row : rows)
+            {
+                bool keep = true;
+                for (const auto &filter : filters_)
+                {
+                    if (!filter(row))
+                    {
+                        keep = false;
+                        break;
+                    }
+                }
+                if (!keep)
+                    continue;
+
+                summary.entries++;
+                summary.hours += row.hours;
+                if (needs_rows)
+                    sink.row(row);
+            }
+        }
+
+        summary.amounts = Billing::calculate_amounts(summary.hours, client_.hourly_rate);
+        sink.finish(summary);
+        return summary;
+    }
+
+    Summary Source::totals()
+    {
+        class TotalsSink : public Sink
+        {
+        public:
+            bool needs_rows() const override { return false; }
+        };
+
+        TotalsSink sink;
+        return run(sink);
+    }
+}
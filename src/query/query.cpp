@@ -0,0 +1,655 @@
+#include "query/query.hpp"
+#include "billing/constants.hpp"
+#include "calendar/date.hpp"
+#include "storage/archive.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/parallel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Query
+{
+    namespace
+    {
+        struct Token
+        {
+            std::string text;
+            size_t pos;
+            bool quoted;
+        };
+
+        std::vector<Token> lex(const std::string &text)
+        {
+            static const std::string SPECIAL = "(),<>!=\"";
+
+            std::vector<Token> tokens;
+            size_t i = 0;
+            while (i < text.size())
+            {
+                char c = text[i];
+                if (c == ' ' || c == '\t')
+                {
+                    i++;
+                }
+                else if (c == '"')
+                {
+                    size_t end = text.find('"', i + 1);
+                    if (end == std::string::npos)
+                        throw std::runtime_error("Unterminated quote at position " + std::to_string(i + 1));
+                    tokens.push_back({text.substr(i + 1, end - i - 1), i, true});
+                    i = end + 1;
+                }
+                else if (c == '(' || c == ')' || c == ',')
+                {
+                    tokens.push_back({std::string(1, c), i, false});
+                    i++;
+                }
+                else if (c == '<' || c == '>' || c == '!' || c == '=')
+                {
+                    size_t size = i + 1 < text.size() && text[i + 1] == '=' && c != '=' ? 2 : 1;
+                    tokens.push_back({text.substr(i, size), i, false});
+                    i += size;
+                }
+                else
+                {
+                    size_t start = i;
+                    while (i < text.size() && text[i] != ' ' && text[i] != '\t' &&
+                           SPECIAL.find(text[i]) == std::string::npos)
+                        i++;
+                    tokens.push_back({text.substr(start, i - start), start, false});
+                }
+            }
+            return tokens;
+        }
+
+        std::string lower(std::string text)
+        {
+            for (char &c : text)
+            {
+                if (c >= 'A' && c <= 'Z')
+                    c = static_cast<char>(c - 'A' + 'a');
+            }
+            return text;
+        }
+
+        constexpr const char *WEEKDAYS[] = {"mon", "tue", "wed", "thu", "fri", "sat", "sun"};
+        constexpr const char *WEEKDAY_NAMES[] = {"monday", "tuesday", "wednesday", "thursday",
+                                                 "friday", "saturday", "sunday"};
+        constexpr const char *WEEKDAY_LABELS[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+        const char *field_name(Field field)
+        {
+            switch (field)
+            {
+            case Field::Client:
+                return "client";
+            case Field::Tag:
+                return "tag";
+            case Field::Date:
+                return "date";
+            case Field::Year:
+                return "year";
+            case Field::Month:
+                return "month";
+            case Field::Weekday:
+                return "weekday";
+            case Field::Hours:
+                return "hours";
+            }
+            return "";
+        }
+
+        const char *column_name(Column column)
+        {
+            switch (column)
+            {
+            case Column::Hours:
+                return "hours";
+            case Column::Amount:
+                return "amount";
+            case Column::Vat:
+                return "vat";
+            case Column::Total:
+                return "total";
+            }
+            return "";
+        }
+
+        const char *function_name(Function function)
+        {
+            switch (function)
+            {
+            case Function::Count:
+                return "count";
+            case Function::Sum:
+                return "sum";
+            case Function::Avg:
+                return "avg";
+            case Function::Min:
+                return "min";
+            case Function::Max:
+                return "max";
+            }
+            return "";
+        }
+
+        class Parser
+        {
+        public:
+            explicit Parser(const std::string &text) : tokens_(lex(text)) {}
+
+            Plan parse()
+            {
+                Plan plan;
+                do
+                {
+                    plan.aggregates.push_back(aggregate());
+                } while (accept(","));
+
+                while (pos_ < tokens_.size())
+                {
+                    if (accept("where"))
+                    {
+                        do
+                        {
+                            plan.filters.push_back(filter());
+                        } while (accept("and"));
+                    }
+                    else if (accept("by"))
+                    {
+                        do
+                        {
+                            if (plan.keys.size() == 2)
+                                fail("at most two group keys are supported");
+                            Field key = field();
+                            if (key == Field::Hours)
+                                fail("cannot group by hours");
+                            plan.keys.push_back(key);
+                        } while (accept(","));
+                    }
+                    else
+                    {
+                        fail("expected 'where' or 'by'");
+                    }
+                }
+                return plan;
+            }
+
+        private:
+            [[noreturn]] void fail(const std::string &message) const
+            {
+                if (pos_ < tokens_.size())
+                    throw std::runtime_error("Query error at '" + tokens_[pos_].text + "' (position " +
+                                             std::to_string(tokens_[pos_].pos + 1) + "): " + message);
+                throw std::runtime_error("Query error at end of query: " + message);
+            }
+
+            bool accept(const std::string &word)
+            {
+                if (pos_ < tokens_.size() && !tokens_[pos_].quoted && lower(tokens_[pos_].text) == word)
+                {
+                    pos_++;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(const std::string &word)
+            {
+                if (!accept(word))
+                    fail("expected '" + word + "'");
+            }
+
+            Aggregate aggregate()
+            {
+                static const std::map<std::string, Function> FUNCTIONS = {
+                    {"count", Function::Count}, {"sum", Function::Sum}, {"avg", Function::Avg},
+                    {"min", Function::Min}, {"max", Function::Max}};
+                static const std::map<std::string, Column> COLUMNS = {
+                    {"hours", Column::Hours}, {"amount", Column::Amount},
+                    {"vat", Column::Vat}, {"total", Column::Total}};
+
+                auto function = pos_ < tokens_.size() ? FUNCTIONS.find(lower(tokens_[pos_].text)) : FUNCTIONS.end();
+                if (function == FUNCTIONS.end())
+                    fail("expected count, sum, avg, min or max");
+                pos_++;
+
+                Aggregate aggregate;
+                aggregate.function = function->second;
+                if (aggregate.function == Function::Count)
+                {
+                    if (accept("("))
+                        expect(")");
+                    return aggregate;
+                }
+
+                expect("(");
+                auto column = pos_ < tokens_.size() ? COLUMNS.find(lower(tokens_[pos_].text)) : COLUMNS.end();
+                if (column == COLUMNS.end())
+                    fail("expected hours, amount, vat or total");
+                pos_++;
+                aggregate.column = column->second;
+                expect(")");
+                return aggregate;
+            }
+
+            Field field()
+            {
+                static const std::map<std::string, Field> FIELDS = {
+                    {"client", Field::Client}, {"tag", Field::Tag}, {"date", Field::Date},
+                    {"year", Field::Year}, {"month", Field::Month}, {"weekday", Field::Weekday},
+                    {"hours", Field::Hours}};
+
+                auto it = pos_ < tokens_.size() ? FIELDS.find(lower(tokens_[pos_].text)) : FIELDS.end();
+                if (it == FIELDS.end())
+                    fail("expected client, tag, date, year, month, weekday or hours");
+                pos_++;
+                return it->second;
+            }
+
+            Filter filter()
+            {
+                static const std::map<std::string, Op> OPS = {
+                    {"=", Op::Eq}, {"!=", Op::Ne}, {"<", Op::Lt},
+                    {"<=", Op::Le}, {">", Op::Gt}, {">=", Op::Ge}};
+
+                Filter filter;
+                filter.field = field();
+
+                auto op = pos_ < tokens_.size() ? OPS.find(tokens_[pos_].text) : OPS.end();
+                if (op == OPS.end())
+                    fail("expected a comparison (= != < <= > >=)");
+                pos_++;
+                filter.op = op->second;
+
+                if (pos_ >= tokens_.size())
+                    fail("expected a value");
+                filter.text = tokens_[pos_].text;
+                filter.number = value(filter);
+                pos_++;
+                return filter;
+            }
+
+            double value(const Filter &filter)
+            {
+                const std::string &text = filter.text;
+                switch (filter.field)
+                {
+                case Field::Client:
+                case Field::Tag:
+                    if (filter.op != Op::Eq && filter.op != Op::Ne)
+                        fail(std::string(field_name(filter.field)) + " only supports = and !=");
+                    return 0.0;
+                case Field::Date:
+                {
+                    Calendar::Date date = Calendar::parse_date(text);
+                    if (!date.valid())
+                        fail("expected a date (YYYY-MM-DD)");
+                    return date.value;
+                }
+                case Field::Month:
+                {
+                    Calendar::Date month = Calendar::parse_month(text);
+                    if (!month.valid())
+                        fail("expected a month (YYYY-MM)");
+                    return month.value / 100;
+                }
+                case Field::Weekday:
+                    for (int day = 0; day < 7; day++)
+                    {
+                        if (lower(text) == WEEKDAYS[day] || lower(text) == WEEKDAY_NAMES[day])
+                            return day;
+                    }
+                    fail("expected a weekday (mon .. sun)");
+                case Field::Year:
+                case Field::Hours:
+                {
+                    char *end = nullptr;
+                    double number = std::strtod(text.c_str(), &end);
+                    if (text.empty() || *end != '\0')
+                        fail("expected a number");
+                    if (filter.field == Field::Year && (number < 1 || number > 9999 || number != static_cast<int>(number)))
+                        fail("expected a year");
+                    return number;
+                }
+                }
+                return 0.0;
+            }
+
+            std::vector<Token> tokens_;
+            size_t pos_ = 0;
+        };
+
+        struct Partial
+        {
+            size_t count = 0;
+            double sum = 0.0;
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+        };
+
+        constexpr size_t COLUMNS = 4;
+
+        struct Accumulator
+        {
+            size_t count = 0;
+            double sum[COLUMNS] = {};
+            double min[COLUMNS];
+            double max[COLUMNS];
+
+            Accumulator()
+            {
+                std::fill(std::begin(min), std::end(min), std::numeric_limits<double>::infinity());
+                std::fill(std::begin(max), std::end(max), -std::numeric_limits<double>::infinity());
+            }
+        };
+
+        double money(Column column, double hours, double rate)
+        {
+            if (column == Column::Hours)
+                return hours;
+            Billing::AmountBreakdown amounts = Billing::calculate_amounts(hours, rate);
+            return column == Column::Amount ? amounts.subtotal : column == Column::Vat ? amounts.vat : amounts.total;
+        }
+
+        // Per-row kernels: plain loops over the table's contiguous columns.
+        void derive(Field field, const uint32_t *dates, const double *hours, size_t n, std::vector<double> &out)
+        {
+            out.resize(n);
+            switch (field)
+            {
+            case Field::Date:
+                for (size_t i = 0; i < n; i++)
+                    out[i] = dates[i];
+                break;
+            case Field::Year:
+                for (size_t i = 0; i < n; i++)
+                    out[i] = dates[i] / 10000;
+                break;
+            case Field::Month:
+                for (size_t i = 0; i < n; i++)
+                    out[i] = dates[i] / 100;
+                break;
+            case Field::Weekday:
+                for (size_t i = 0; i < n; i++)
+                    out[i] = Calendar::weekday(Calendar::Date(dates[i]));
+                break;
+            case Field::Hours:
+                for (size_t i = 0; i < n; i++)
+                    out[i] = hours[i];
+                break;
+            default:
+                break;
+            }
+        }
+
+        void select(const std::vector<double> &values, Op op, double rhs, std::vector<uint8_t> &keep)
+        {
+            size_t n = values.size();
+            switch (op)
+            {
+            case Op::Eq:
+                for (size_t i = 0; i < n; i++)
+                    keep[i] &= values[i] == rhs;
+                break;
+            case Op::Ne:
+                for (size_t i = 0; i < n; i++)
+                    keep[i] &= values[i] != rhs;
+                break;
+            case Op::Lt:
+                for (size_t i = 0; i < n; i++)
+                    keep[i] &= values[i] < rhs;
+                break;
+            case Op::Le:
+                for (size_t i = 0; i < n; i++)
+                    keep[i] &= values[i] <= rhs;
+                break;
+            case Op::Gt:
+                for (size_t i = 0; i < n; i++)
+                    keep[i] &= values[i] > rhs;
+                break;
+            case Op::Ge:
+                for (size_t i = 0; i < n; i++)
+                    keep[i] &= values[i] >= rhs;
+                break;
+            }
+        }
+
+        bool matches(Op op, const std::string &value, const std::string &rhs)
+        {
+            return op == Op::Eq ? value == rhs : value != rhs;
+        }
+
+        struct Dictionaries
+        {
+            std::vector<std::string> clients;
+            std::vector<std::string> tags;
+        };
+
+        // Scans one client. Returns per-group accumulators keyed by the packed group key.
+        std::unordered_map<uint64_t, Accumulator> scan(const Plan &plan, const Dictionaries &dictionaries,
+                                                       const std::string &id, const ClientData &data)
+        {
+            std::unordered_map<uint64_t, Accumulator> result;
+            for (const auto &filter : plan.filters)
+            {
+                if ((filter.field == Field::Client && !matches(filter.op, id, filter.text)) ||
+                    (filter.field == Field::Tag && !matches(filter.op, data.tag, filter.text)))
+                    return result;
+            }
+
+            const uint32_t *dates = data.logs.dates().data();
+            const double *hours = data.logs.hours().data();
+            size_t n = data.logs.size();
+
+            std::vector<uint8_t> keep(n, 1);
+            std::vector<double> values;
+            for (const auto &filter : plan.filters)
+            {
+                if (filter.field == Field::Client || filter.field == Field::Tag)
+                    continue;
+                derive(filter.field, dates, hours, n, values);
+                select(values, filter.op, filter.number, keep);
+            }
+
+            // Gather the selected rows so keys are only derived for them.
+            std::vector<uint32_t> selected_dates;
+            std::vector<double> selected_hours;
+            for (size_t i = 0; i < n; i++)
+            {
+                if (keep[i])
+                {
+                    selected_dates.push_back(dates[i]);
+                    selected_hours.push_back(hours[i]);
+                }
+            }
+            size_t m = selected_dates.size();
+            if (m == 0)
+                return result;
+
+            std::vector<uint64_t> keys(m, 0);
+            for (size_t k = 0; k < plan.keys.size(); k++)
+            {
+                int shift = plan.keys.size() == 2 && k == 0 ? 32 : 0;
+                Field key = plan.keys[k];
+                if (key == Field::Client || key == Field::Tag)
+                {
+                    const auto &dictionary = key == Field::Client ? dictionaries.clients : dictionaries.tags;
+                    const std::string &value = key == Field::Client ? id : data.tag;
+                    uint64_t code = std::lower_bound(dictionary.begin(), dictionary.end(), value) - dictionary.begin();
+                    for (size_t i = 0; i < m; i++)
+                        keys[i] |= code << shift;
+                }
+                else
+                {
+                    derive(key, selected_dates.data(), selected_hours.data(), m, values);
+                    for (size_t i = 0; i < m; i++)
+                        keys[i] |= static_cast<uint64_t>(values[i]) << shift;
+                }
+            }
+
+            // Rows are sorted by date, so date-derived keys come in runs.
+            std::unordered_map<uint64_t, Partial> groups;
+            Partial *group = nullptr;
+            uint64_t current = 0;
+            for (size_t i = 0; i < m; i++)
+            {
+                if (group == nullptr || keys[i] != current)
+                {
+                    current = keys[i];
+                    group = &groups[current];
+                }
+                group->count++;
+                group->sum += selected_hours[i];
+                group->min = std::min(group->min, selected_hours[i]);
+                group->max = std::max(group->max, selected_hours[i]);
+            }
+
+            // Money is linear and monotonic in hours, so it is derived per group.
+            for (const auto &[key, partial] : groups)
+            {
+                Accumulator &acc = result[key];
+                acc.count = partial.count;
+                for (size_t c = 0; c < COLUMNS; c++)
+                {
+                    Column column = static_cast<Column>(c);
+                    acc.sum[c] = money(column, partial.sum, data.hourly_rate);
+                    acc.min[c] = money(column, partial.min, data.hourly_rate);
+                    acc.max[c] = money(column, partial.max, data.hourly_rate);
+                }
+            }
+            return result;
+        }
+
+        std::string label(Field key, uint32_t code, const Dictionaries &dictionaries)
+        {
+            switch (key)
+            {
+            case Field::Client:
+                return dictionaries.clients[code];
+            case Field::Tag:
+                return dictionaries.tags[code];
+            case Field::Date:
+                return Calendar::iso(Calendar::Date(code)).str();
+            case Field::Month:
+                return Calendar::month_key(Calendar::Date(code * 100)).str();
+            case Field::Weekday:
+                return WEEKDAY_LABELS[code];
+            default:
+                return std::to_string(code);
+            }
+        }
+    }
+
+    Plan parse(const std::string &text)
+    {
+        return Parser(text).parse();
+    }
+
+    Result run(const Plan &plan, const std::map<std::string, ClientData> &clients, unsigned threads)
+    {
+        Dictionaries dictionaries;
+        std::set<std::string> tags;
+        std::vector<std::pair<const std::string *, const ClientData *>> list;
+        for (const auto &[id, data] : clients)
+        {
+            dictionaries.clients.push_back(id);
+            tags.insert(data.tag);
+            list.emplace_back(&id, &data);
+        }
+        dictionaries.tags.assign(tags.begin(), tags.end());
+
+        std::vector<std::unordered_map<uint64_t, Accumulator>> partials(list.size());
+        parallel_for(list.size(), threads, [&](size_t i) {
+            partials[i] = scan(plan, dictionaries, *list[i].first, *list[i].second);
+        });
+
+        std::map<uint64_t, Accumulator> groups;
+        for (const auto &partial : partials)
+        {
+            for (const auto &[key, acc] : partial)
+            {
+                Accumulator &total = groups[key];
+                total.count += acc.count;
+                for (size_t c = 0; c < COLUMNS; c++)
+                {
+                    total.sum[c] += acc.sum[c];
+                    total.min[c] = std::min(total.min[c], acc.min[c]);
+                    total.max[c] = std::max(total.max[c], acc.max[c]);
+                }
+            }
+        }
+
+        Result result;
+        for (Field key : plan.keys)
+            result.key_names.push_back(field_name(key));
+        for (const auto &aggregate : plan.aggregates)
+        {
+            result.value_names.push_back(aggregate.function == Function::Count
+                                             ? std::string("count")
+                                             : std::string(function_name(aggregate.function)) + "(" +
+                                                   column_name(aggregate.column) + ")");
+        }
+
+        for (const auto &[key, acc] : groups)
+        {
+            Row row;
+            for (size_t k = 0; k < plan.keys.size(); k++)
+            {
+                int shift = plan.keys.size() == 2 && k == 0 ? 32 : 0;
+                row.keys.push_back(label(plan.keys[k], static_cast<uint32_t>(key >> shift), dictionaries));
+            }
+            for (const auto &aggregate : plan.aggregates)
+            {
+                size_t c = static_cast<size_t>(aggregate.column);
+                switch (aggregate.function)
+                {
+                case Function::Count:
+                    row.values.push_back(static_cast<double>(acc.count));
+                    break;
+                case Function::Sum:
+                    row.values.push_back(acc.sum[c]);
+                    break;
+                case Function::Avg:
+                    row.values.push_back(acc.sum[c] / static_cast<double>(acc.count));
+                    break;
+                case Function::Min:
+                    row.values.push_back(acc.min[c]);
+                    break;
+                case Function::Max:
+                    row.values.push_back(acc.max[c]);
+                    break;
+                }
+            }
+            result.rows.push_back(std::move(row));
+        }
+        return result;
+    }
+
+    Result run(const std::string &text, unsigned threads)
+    {
+        Plan plan = parse(text);
+        std::map<std::string, ClientData> clients = BatchLoader::load_all(threads);
+
+        std::vector<std::pair<const std::string *, ClientData *>> archived;
+        for (auto &[id, data] : clients)
+        {
+            if (!data.archived_months.empty())
+                archived.emplace_back(&id, &data);
+        }
+
+        // The archive table owns its pool; the shared pool is only read here.
+        parallel_for(archived.size(), threads, [&](size_t i) {
+            WorkLogTable logs = ArchiveManager::load(*archived[i].first);
+            logs.merge(archived[i].second->logs);
+            archived[i].second->logs = std::move(logs);
+        });
+
+        return run(plan, clients, threads);
+    }
+}
@@ -0,0 +1,217 @@
+#include "report/renderer.hpp"
+#include "report/work_log.hpp"
+#include "billing/constants.hpp"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+static constexpr size_t INITIAL_CAPACITY = 16 * 1024;
+
+static const char *const HTML_HEAD =
+    "<!DOCTYPE html>\n"
+    "<html lang=\"en\">\n"
+    "<head>\n"
+    "<meta charset=\"utf-8\">\n"
+    "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">\n"
+    "<style>\n"
+    "body { font-family: Helvetica, Arial, sans-serif; color: #222; max-width: 50em; margin: 2em auto; padding: 0 1em; }\n"
+    "h1 { margin-bottom: 0.3em; }\n"
+    ".meta { color: #555; }\n"
+    "table { border-collapse: collapse; }\n"
+    ".entries { width: 100%; margin-top: 1.5em; }\n"
+    ".entries th { background: #f29a1a; color: #fff; text-align: left; padding: 0.5em 0.8em; }\n"
+    ".entries td { padding: 0.4em 0.8em; vertical-align: top; }\n"
+    ".entries tbody tr:nth-child(even) { background: #f2f2f2; }\n"
+    ".date, .number { white-space: nowrap; }\n"
+    ".number { text-align: right; }\n"
+    ".summary { margin: 1.5em 0 0 auto; background: #f2f2f2; border-radius: 5px; }\n"
+    ".summary th { text-align: left; font-weight: normal; padding: 0.3em 1em; }\n"
+    ".summary td { padding: 0.3em 1em; }\n"
+    ".summary .total { font-weight: bold; }\n"
+    "</style>\n";
+
+static std::string_view currency_symbol(const std::string &currency)
+{
+    if (currency == "EUR")
+        return "€";
+    if (currency == "USD")
+        return "$";
+    if (currency == "GBP")
+        return "£";
+    return currency;
+}
+
+static std::string vat_label()
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "VAT (%g%%)", Billing::VAT_RATE * 100);
+    return text;
+}
+
+std::unique_ptr<ReportRenderer> ReportRenderer::create(ReportFormat format)
+{
+    switch (format)
+    {
+    case ReportFormat::Html:
+        return std::make_unique<HtmlReportRenderer>();
+    case ReportFormat::Markdown:
+        return std::make_unique<MarkdownReportRenderer>();
+    case ReportFormat::Pdf:
+        break;
+    }
+    return std::make_unique<PdfReportRenderer>();
+}
+
+void TextReportRenderer::save(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Could not write " + path);
+    file.write(text_.data(), static_cast<std::streamsize>(text_.size()));
+}
+
+void TextReportRenderer::append_number(double value, int decimals)
+{
+    char text[32];
+    int size = std::snprintf(text, sizeof(text), "%.*f", decimals, value);
+    text_.append(text, static_cast<size_t>(size));
+}
+
+void TextReportRenderer::append_amount(const WorkLogReportData &data, double amount)
+{
+    text_.append(currency_symbol(data.currency));
+    text_.push_back(' ');
+    append_number(amount, 2);
+}
+
+void HtmlReportRenderer::begin(const WorkLogReportData &data)
+{
+    text_.clear();
+    text_.reserve(INITIAL_CAPACITY);
+    text_.append(HTML_HEAD);
+    text_.append("<title>Work Log Report - ");
+    append_escaped(data.client_name);
+    text_.append(" - ");
+    append_escaped(data.month);
+    text_.append("</title>\n</head>\n<body>\n<h1>Work Log Report</h1>\n<p class=\"meta\">Client: ");
+    append_escaped(data.client_name);
+    text_.append("<br>\nPeriod: ");
+    append_escaped(data.month);
+    text_.append("</p>\n<table class=\"entries\">\n"
+                 "<thead><tr><th>Date</th><th class=\"number\">Hours</th><th>Description</th></tr></thead>\n"
+                 "<tbody>\n");
+}
+
+void HtmlReportRenderer::row(Calendar::Date date, double hours, std::string_view message)
+{
+    text_.append("<tr><td class=\"date\">");
+    text_.append(Calendar::long_date(date).view());
+    text_.append("</td><td class=\"number\">");
+    append_number(hours, 1);
+    text_.append("</td><td>");
+    append_escaped(message);
+    text_.append("</td></tr>\n");
+}
+
+void HtmlReportRenderer::finish(const WorkLogReportData &data)
+{
+    text_.append("</tbody>\n</table>\n<table class=\"summary\">\n<tr><th>Total Hours:</th><td class=\"number\">");
+    append_number(data.total_hours, 1);
+    text_.append("</td></tr>\n<tr><th>Hourly Rate:</th><td class=\"number\">");
+    append_amount(data, data.hourly_rate);
+    text_.append("</td></tr>\n<tr><th>Subtotal:</th><td class=\"number\">");
+    append_amount(data, data.subtotal);
+    text_.append("</td></tr>\n<tr><th>");
+    text_.append(vat_label());
+    text_.append(":</th><td class=\"number\">");
+    append_amount(data, data.vat);
+    text_.append("</td></tr>\n<tr class=\"total\"><th>Total:</th><td class=\"number\">");
+    append_amount(data, data.total);
+    text_.append("</td></tr>\n</table>\n</body>\n</html>\n");
+}
+
+void HtmlReportRenderer::append_escaped(std::string_view text)
+{
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '&': text_.append("&amp;"); break;
+        case '<': text_.append("&lt;"); break;
+        case '>': text_.append("&gt;"); break;
+        case '"': text_.append("&quot;"); break;
+        case '\'': text_.append("&#39;"); break;
+        default: text_.push_back(c);
+        }
+    }
+}
+
+void MarkdownReportRenderer::begin(const WorkLogReportData &data)
+{
+    text_.clear();
+    text_.reserve(INITIAL_CAPACITY);
+    text_.append("# Work Log Report\n\n**Client:** ");
+    append_escaped(data.client_name);
+    text_.append("  \n**Period:** ");
+    append_escaped(data.month);
+    text_.append("\n\n| Date | Hours | Description |\n|------|------:|-------------|\n");
+}
+
+void MarkdownReportRenderer::row(Calendar::Date date, double hours, std::string_view message)
+{
+    text_.append("| ");
+    text_.append(Calendar::long_date(date).view());
+    text_.append(" | ");
+    append_number(hours, 1);
+    text_.append(" | ");
+    append_escaped(message);
+    text_.append(" |\n");
+}
+
+void MarkdownReportRenderer::finish(const WorkLogReportData &data)
+{
+    text_.append("\n| | |\n|---|---:|\n| Total Hours | ");
+    append_number(data.total_hours, 1);
+    text_.append(" |\n| Hourly Rate | ");
+    append_amount(data, data.hourly_rate);
+    text_.append(" |\n| Subtotal | ");
+    append_amount(data, data.subtotal);
+    text_.append(" |\n| ");
+    text_.append(vat_label());
+    text_.append(" | ");
+    append_amount(data, data.vat);
+    text_.append(" |\n| **Total** | **");
+    append_amount(data, data.total);
+    text_.append("** |\n");
+}
+
+// Table cells are one line, and markup characters are taken literally.
+void MarkdownReportRenderer::append_escaped(std::string_view text)
+{
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '\n':
+        case '\r':
+        case '\t':
+            text_.push_back(' ');
+            break;
+        case '\\':
+        case '|':
+        case '*':
+        case '_':
+        case '`':
+        case '[':
+        case ']':
+        case '<':
+        case '>':
+        case '#':
+            text_.push_back('\\');
+            text_.push_back(c);
+            break;
+        default:
+            text_.push_back(c);
+        }
+    }
+}
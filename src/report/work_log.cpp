@@ -241,11 +241,11 @@ std::string WorkLogPDFBuilder::format_currency(double amount)
     return oss.str();
 }
 
-std::vector<std::string> WorkLogPDFBuilder::wrap_text(const std::string &text, float max_width)
+std::vector<std::string> WorkLogPDFBuilder::wrap_text(std::string_view text, float max_width)
 {
     std::vector<std::string> lines;
     std::string current_line;
-    std::istringstream words_stream(text);
+    std::istringstream words_stream{std::string(text)};
     std::string word;
 
     while (words_stream >> word)
@@ -275,81 +275,172 @@ std::vector<std::string> WorkLogPDFBuilder::wrap_text(const std::string &text, f
     return lines;
 }
 
-std::string WorkLogPDFBuilder::format_date(const std::string &date)
+Calendar::Text WorkLogPDFBuilder::format_date(std::string_view date)
 {
-    std::tm tm = {};
-    std::istringstream ss(date);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
+    Calendar::Date parsed = Calendar::parse_stored_date(date);
+    if (!parsed.valid())
+    {
+        Calendar::Text text;
+        text.append(date);
+        return text;
+    }
+    return Calendar::long_date(parsed);
+}
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%b %d, %Y");
-    return oss.str();
+void WorkLogReportSink::begin(const ClientData &client)
+{
+    data_.client_name = client.name;
+    data_.hourly_rate = client.hourly_rate;
+}
+
+void WorkLogReportSink::row(const WorkLogRow &row)
+{
+    WorkLogEntry entry;
+    entry.date = Calendar::iso(row.date);
+    entry.hours = row.hours;
+    entry.message = row.message;
+    data_.entries.push_back(std::move(entry));
+}
+
+void WorkLogReportSink::finish(const Pipeline::Summary &summary)
+{
+    data_.total_hours = summary.hours;
+    data_.subtotal = summary.amounts.subtotal;
+    data_.vat = summary.amounts.vat;
+    data_.total = summary.amounts.total;
+}
+
+void ReportRenderSink::begin(const ClientData &client)
+{
+    data_.client_name = client.name;
+    data_.hourly_rate = client.hourly_rate;
+    renderer_.begin(data_);
+}
+
+void ReportRenderSink::row(const WorkLogRow &row)
+{
+    renderer_.row(row.date, row.hours, row.message);
+}
+
+void ReportRenderSink::finish(const Pipeline::Summary &summary)
+{
+    if (summary.entries == 0)
+    {
+        throw std::runtime_error("No work logs found for " + data_.month);
+    }
+
+    data_.total_hours = summary.hours;
+    data_.subtotal = summary.amounts.subtotal;
+    data_.vat = summary.amounts.vat;
+    data_.total = summary.amounts.total;
+    renderer_.finish(data_);
+}
+
+void PdfReportRenderer::begin(const WorkLogReportData &data)
+{
+    data_.client_name = data.client_name;
+    data_.month = data.month;
+    data_.currency = data.currency;
+    data_.hourly_rate = data.hourly_rate;
+    data_.entries.clear();
+}
+
+void PdfReportRenderer::row(Calendar::Date date, double hours, std::string_view message)
+{
+    WorkLogEntry entry;
+    entry.date = Calendar::iso(date);
+    entry.hours = hours;
+    entry.message = message;
+    data_.entries.push_back(std::move(entry));
+}
+
+void PdfReportRenderer::finish(const WorkLogReportData &data)
+{
+    data_.total_hours = data.total_hours;
+    data_.subtotal = data.subtotal;
+    data_.vat = data.vat;
+    data_.total = data.total;
+}
+
+void PdfReportRenderer::save(const std::string &path) const
+{
+    WorkLogPDFBuilder builder(data_);
+    builder.build();
+    builder.save(path);
+}
+
+ReportFormat WorkLogReport::parse_format(const std::string &name)
+{
+    if (name == "pdf")
+        return ReportFormat::Pdf;
+    if (name == "html")
+        return ReportFormat::Html;
+    if (name == "md" || name == "markdown")
+        return ReportFormat::Markdown;
+    throw std::runtime_error("Unknown report format: " + name + " (use pdf, html or md)");
+}
+
+std::string WorkLogReport::output_path(const std::string &client_id, const std::string &month, ReportFormat format)
+{
+    const char *extension = format == ReportFormat::Html ? ".html" : format == ReportFormat::Markdown ? ".md" : ".pdf";
+    return "worklog-" + client_id + "-" + month + extension;
 }
 
 WorkLogReportData WorkLogReport::prepare_data(const std::string &client_id, const std::string &month)
 {
     AppConfig config = ConfigManager::load();
-    ClientData client = ClientManager::load(client_id);
-
     std::string month_key = month.empty() ? ClientManager::get_previous_month_key() : month;
 
     WorkLogReportData data;
-    data.client_name = client.name;
     data.month = month_key;
     data.currency = config.company.currency;
-    data.hourly_rate = client.hourly_rate;
-    data.total_hours = 0;
 
-    if (client.logs.count(month_key))
-    {
-        std::vector<std::pair<std::string, WorkLog>> sorted_logs;
-        for (const auto &[date, log] : client.logs.at(month_key))
-        {
-            sorted_logs.push_back({date, log});
-        }
+    WorkLogReportSink sink(data);
+    Pipeline::Source::month(client_id, month_key).run(sink);
+    return data;
+}
 
-        std::sort(sorted_logs.begin(), sorted_logs.end(),
-                  [](const auto &a, const auto &b)
-                  { return a.first < b.first; });
+void WorkLogReport::render(const WorkLogReportData &data, ReportRenderer &renderer)
+{
+    renderer.begin(data);
+    for (const auto &entry : data.entries)
+    {
+        renderer.row(Calendar::parse_stored_date(entry.date), entry.hours, entry.message);
+    }
+    renderer.finish(data);
+}
 
-        for (const auto &[date, log] : sorted_logs)
-        {
-            WorkLogEntry entry;
-            entry.date = date;
-            entry.hours = log.hours;
-            entry.message = log.message;
-            data.entries.push_back(entry);
-            data.total_hours += log.hours;
-        }
+std::string WorkLogReport::save(const std::string &client_id, const WorkLogReportData &data, ReportFormat format)
+{
+    if (data.entries.empty())
+    {
+        throw std::runtime_error("No work logs found for " + data.month);
     }
 
-    Billing::AmountBreakdown amounts = Billing::calculate_amounts(data.total_hours, data.hourly_rate);
-    data.subtotal = amounts.subtotal;
-    data.vat = amounts.vat;
-    data.total = amounts.total;
+    std::unique_ptr<ReportRenderer> renderer = ReportRenderer::create(format);
+    render(data, *renderer);
 
-    return data;
+    std::string path = output_path(client_id, data.month, format);
+    renderer->save(path);
+    return path;
 }
 
-std::string WorkLogReport::generate(const std::string &client_id, const std::string &month)
+std::string WorkLogReport::generate(const std::string &client_id, const std::string &month, ReportFormat format)
 {
     if (!ClientManager::client_exists(client_id))
     {
         throw std::runtime_error("Client not found: " + client_id);
     }
 
-    WorkLogReportData data = prepare_data(client_id, month);
-
-    if (data.entries.empty())
-    {
-        throw std::runtime_error("No work logs found for " + data.month);
-    }
-
-    std::string output_path = "worklog-" + client_id + "-" + data.month + ".pdf";
+    WorkLogReportData data;
+    data.month = month.empty() ? ClientManager::get_previous_month_key() : month;
+    data.currency = ConfigManager::load().company.currency;
 
-    WorkLogPDFBuilder builder(data);
-    builder.build();
-    builder.save(output_path);
+    std::unique_ptr<ReportRenderer> renderer = ReportRenderer::create(format);
+    ReportRenderSink sink(data, *renderer);
+    Pipeline::Source::month(client_id, data.month).run(sink);
 
-    return output_path;
+    std::string path = output_path(client_id, data.month, format);
+    renderer->save(path);
+    return path;
 }
@@ -0,0 +1,80 @@
+#include "storage/archive.hpp"
+#include "storage/client_decoder.hpp"
+#include "storage/client_encoder.hpp"
+#include "storage/compression.hpp"
+#include "storage/config.hpp"
+#include "storage/durable_file.hpp"
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+static constexpr int COMPRESSION_LEVEL = 9;
+
+static void save_archive(const std::string &client_id, const WorkLogTable &logs)
+{
+    fs::create_directories(ArchiveManager::get_archive_dir());
+    std::string contents = ClientEncoder::encode_logs(logs.all(), JsonFormat::Compact);
+    DurableFile::write(ArchiveManager::get_archive_path(client_id), Compression::compress(contents, COMPRESSION_LEVEL));
+}
+
+std::string ArchiveManager::get_archive_dir()
+{
+    return ConfigManager::get_config_dir() + "/archive";
+}
+
+std::string ArchiveManager::get_archive_path(const std::string &client_id)
+{
+    return get_archive_dir() + "/" + client_id + ".json.zst";
+}
+
+WorkLogTable ArchiveManager::load(const std::string &client_id)
+{
+    std::string path = get_archive_path(client_id);
+    std::string compressed;
+    if (!DurableFile::read(path, compressed))
+    {
+        return {};
+    }
+
+    std::string contents = Compression::decompress(compressed, "archive: " + path);
+    return ClientDecoder::decode_logs(contents);
+}
+
+int ArchiveManager::archive_client(const std::string &client_id, const std::string &cutoff_month)
+{
+    Calendar::Date cutoff = Calendar::parse_month(cutoff_month);
+    if (!cutoff.valid())
+    {
+        throw std::runtime_error("Invalid archive cutoff: " + cutoff_month);
+    }
+
+    ClientData data = ClientManager::load(client_id);
+    Calendar::Date last = Calendar::Date(cutoff.value - 1);
+    WorkLogTable moved = data.logs.slice(Calendar::Date(), last);
+    if (moved.empty())
+    {
+        return 0;
+    }
+    data.logs.erase(Calendar::Date(), last);
+
+    std::vector<Calendar::Date> months = moved.months();
+    for (Calendar::Date month : months)
+    {
+        data.archived_months.insert(Calendar::month_key(month).str());
+    }
+
+    WorkLogTable archive = load(client_id);
+    archive.merge(moved);
+
+    // Archive first: a crash before the client save only leaves duplicates.
+    save_archive(client_id, archive);
+    ClientManager::save(client_id, data);
+
+    return static_cast<int>(months.size());
+}
+
+std::string ArchiveManager::get_cutoff_month(int horizon_months)
+{
+    return Calendar::month_key(Calendar::add_months(Calendar::today(), -horizon_months)).str();
+}
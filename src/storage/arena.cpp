@@ -0,0 +1,67 @@
+#include "storage/arena.hpp"
+
+static std::atomic<uint64_t> next_arena_id{1};
+
+// The calling thread's buffer in the arena it last allocated from.
+struct ThreadCache
+{
+    uint64_t arena = 0;
+    void *buffer = nullptr;
+};
+
+static thread_local ThreadCache thread_cache;
+
+void *CommandArena::ChunkResource::do_allocate(size_t bytes, size_t alignment)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffer_.allocate(bytes, alignment);
+}
+
+CommandArena::ThreadedResource::ThreadedResource(size_t initial_size)
+    : id_(next_arena_id++), chunks_(initial_size)
+{
+}
+
+CommandArena::ThreadBuffer &CommandArena::ThreadedResource::local()
+{
+    if (thread_cache.arena == id_)
+        return *static_cast<ThreadBuffer *>(thread_cache.buffer);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<ThreadBuffer> &buffer = threads_[std::this_thread::get_id()];
+    if (!buffer)
+        buffer = std::make_unique<ThreadBuffer>(&chunks_);
+    thread_cache = {id_, buffer.get()};
+    return *buffer;
+}
+
+void *CommandArena::ThreadedResource::do_allocate(size_t bytes, size_t alignment)
+{
+    ThreadBuffer &buffer = local();
+    buffer.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    return buffer.buffer.allocate(bytes, alignment);
+}
+
+size_t CommandArena::ThreadedResource::bytes_allocated() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto &[thread, buffer] : threads_)
+        total += buffer->bytes.load(std::memory_order_relaxed);
+    return total;
+}
+
+CommandArena::CommandArena(size_t initial_size)
+    : resource_(initial_size), previous_(std::pmr::set_default_resource(&resource_))
+{
+}
+
+CommandArena::~CommandArena()
+{
+    std::pmr::set_default_resource(previous_);
+}
+
+size_t CommandArena::bytes_allocated() const
+{
+    return resource_.bytes_allocated();
+}
@@ -0,0 +1,401 @@
+#include "storage/backup.hpp"
+#include "storage/compression.hpp"
+#include "storage/config.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/search_index.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+
+static constexpr int COMPRESSION_LEVEL = 3;
+
+struct SnapshotFile
+{
+    std::string path;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    std::vector<std::string> chunks;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(SnapshotFile, path, size, mtime, chunks)
+};
+
+struct Snapshot
+{
+    std::vector<SnapshotFile> files;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(Snapshot, files)
+};
+
+// Gear table for the rolling hash, filled from a fixed splitmix64 sequence so
+// boundaries are the same on every machine.
+static constexpr std::array<uint64_t, 256> make_gear()
+{
+    std::array<uint64_t, 256> gear = {};
+    uint64_t state = 0x2545f4914f6cdd1dull;
+    for (auto &value : gear)
+    {
+        state += 0x9e3779b97f4a7c15ull;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        value = z ^ (z >> 31);
+    }
+    return gear;
+}
+
+static constexpr std::array<uint64_t, 256> GEAR = make_gear();
+
+// Normalized chunking: a stricter mask before the average size and a looser
+// one after it keeps chunk sizes close to AVG_CHUNK.
+static constexpr uint64_t MASK_SMALL = ((1ull << 15) - 1) << 49;
+static constexpr uint64_t MASK_LARGE = ((1ull << 11) - 1) << 53;
+
+class Sha256
+{
+public:
+    static std::string hex(std::string_view data)
+    {
+        Sha256 sha;
+        sha.update(data);
+        return sha.finish();
+    }
+
+private:
+    void update(std::string_view data)
+    {
+        for (char c : data)
+        {
+            block_[block_size_++] = static_cast<uint8_t>(c);
+            if (block_size_ == 64)
+            {
+                transform();
+                block_size_ = 0;
+            }
+        }
+        length_ += data.size();
+    }
+
+    std::string finish()
+    {
+        uint64_t bits = length_ * 8;
+        update(std::string_view("\x80", 1));
+        while (block_size_ != 56)
+            update(std::string_view("\0", 1));
+        for (int i = 7; i >= 0; i--)
+            block_[block_size_++] = static_cast<uint8_t>(bits >> (8 * i));
+        transform();
+
+        static constexpr char HEX[] = "0123456789abcdef";
+        std::string text;
+        for (uint32_t word : state_)
+        {
+            for (int i = 7; i >= 0; i--)
+                text.push_back(HEX[(word >> (4 * i)) & 0xf]);
+        }
+        return text;
+    }
+
+    static uint32_t rotr(uint32_t x, int n)
+    {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    void transform()
+    {
+        static constexpr uint32_t K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++)
+        {
+            w[i] = static_cast<uint32_t>(block_[4 * i]) << 24 | static_cast<uint32_t>(block_[4 * i + 1]) << 16 |
+                   static_cast<uint32_t>(block_[4 * i + 2]) << 8 | block_[4 * i + 3];
+        }
+        for (int i = 16; i < 64; i++)
+        {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+        uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+        for (int i = 0; i < 64; i++)
+        {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state_[0] += a;
+        state_[1] += b;
+        state_[2] += c;
+        state_[3] += d;
+        state_[4] += e;
+        state_[5] += f;
+        state_[6] += g;
+        state_[7] += h;
+    }
+
+    uint32_t state_[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                          0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    uint8_t block_[64] = {};
+    size_t block_size_ = 0;
+    uint64_t length_ = 0;
+};
+
+static std::string chunk_path(const std::string &dest, const std::string &hash)
+{
+    return dest + "/chunks/" + hash.substr(0, 2) + "/" + hash;
+}
+
+static std::string snapshot_path(const std::string &dest, const std::string &name)
+{
+    return dest + "/snapshots/" + name + ".json";
+}
+
+static Snapshot load_snapshot(const std::string &dest, const std::string &name)
+{
+    std::string contents;
+    if (!DurableFile::read(snapshot_path(dest, name), contents))
+        throw std::runtime_error("Snapshot not found: " + name);
+    return nlohmann::json::parse(contents).get<Snapshot>();
+}
+
+static std::string new_snapshot_name(const std::string &dest)
+{
+    std::time_t now = std::time(nullptr);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H%M%S", std::localtime(&now));
+
+    std::string name = text;
+    for (int n = 2; DurableFile::exists(snapshot_path(dest, name)); n++)
+        name = std::string(text) + "-" + std::to_string(n);
+    return name;
+}
+
+static bool is_derived(const std::string &path)
+{
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".tmp") == 0;
+}
+
+// Data files relative to the data directory, skipping derived data and the
+// backup destination itself when it lives inside the data directory.
+static std::vector<std::string> list_data_files(const std::string &dest)
+{
+    fs::path root = ConfigManager::get_config_dir();
+    std::set<fs::path> skip = {fs::path(SearchIndex::get_index_path()), fs::path(SearchIndex::get_journal_path())};
+    fs::path dest_path = fs::weakly_canonical(dest);
+
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root, ec); it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (it->is_directory() && fs::weakly_canonical(it->path()) == dest_path)
+        {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file() || skip.count(it->path()) || is_derived(it->path().string()))
+            continue;
+        files.push_back(it->path().lexically_relative(root).generic_string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::vector<size_t> BackupManager::chunk(std::string_view data)
+{
+    std::vector<size_t> ends;
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        size_t remaining = data.size() - pos;
+        size_t limit = std::min(MAX_CHUNK, remaining);
+        size_t cut = limit;
+
+        if (remaining > MIN_CHUNK)
+        {
+            uint64_t hash = 0;
+            for (size_t i = MIN_CHUNK; i < limit; i++)
+            {
+                hash = (hash << 1) + GEAR[static_cast<uint8_t>(data[pos + i])];
+                if (!(hash & (i < AVG_CHUNK ? MASK_SMALL : MASK_LARGE)))
+                {
+                    cut = i + 1;
+                    break;
+                }
+            }
+        }
+
+        pos += cut;
+        ends.push_back(pos);
+    }
+    return ends;
+}
+
+std::vector<std::string> BackupManager::list(const std::string &dest)
+{
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(dest + "/snapshots", ec))
+    {
+        if (entry.path().extension() == ".json")
+            names.push_back(entry.path().stem().string());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+BackupResult BackupManager::backup(const std::string &dest)
+{
+    std::string root = ConfigManager::get_config_dir();
+    if (!fs::is_directory(root))
+        throw std::runtime_error("No data directory at " + root);
+
+    std::vector<std::string> names = list(dest);
+    std::map<std::string, SnapshotFile> previous;
+    if (!names.empty())
+    {
+        for (auto &file : load_snapshot(dest, names.back()).files)
+            previous[file.path] = std::move(file);
+    }
+
+    BackupResult result;
+    Snapshot snapshot;
+    std::set<std::string> written;
+
+    WriteBatch batch;
+    for (const auto &path : list_data_files(dest))
+    {
+        std::string full_path = root + "/" + path;
+        std::error_code ec;
+        SnapshotFile file;
+        file.path = path;
+        file.size = fs::file_size(full_path, ec);
+        file.mtime = fs::last_write_time(full_path, ec).time_since_epoch().count();
+
+        auto old = previous.find(path);
+        if (old != previous.end() && old->second.size == file.size && old->second.mtime == file.mtime)
+        {
+            file.chunks = old->second.chunks;
+            snapshot.files.push_back(std::move(file));
+            result.files++;
+            continue;
+        }
+
+        std::string contents;
+        if (!DurableFile::read(full_path, contents))
+            continue;
+        file.size = contents.size();
+
+        size_t begin = 0;
+        for (size_t end : chunk(contents))
+        {
+            std::string_view piece(contents.data() + begin, end - begin);
+            std::string hash = Sha256::hex(piece);
+            std::string chunk_file = chunk_path(dest, hash);
+            if (!written.count(hash) && !DurableFile::exists(chunk_file))
+            {
+                std::string compressed = Compression::compress(piece, COMPRESSION_LEVEL);
+                fs::create_directories(fs::path(chunk_file).parent_path());
+                DurableFile::write(chunk_file, compressed);
+                result.chunks_written++;
+                result.bytes_written += compressed.size();
+            }
+            written.insert(hash);
+            file.chunks.push_back(std::move(hash));
+            begin = end;
+        }
+
+        snapshot.files.push_back(std::move(file));
+        result.files++;
+        result.files_read++;
+    }
+
+    fs::create_directories(dest + "/snapshots");
+    result.snapshot = new_snapshot_name(dest);
+    nlohmann::json j = snapshot;
+    DurableFile::write(snapshot_path(dest, result.snapshot), j.dump());
+    batch.commit();
+
+    return result;
+}
+
+std::string BackupManager::restore(const std::string &dest, const std::string &snapshot)
+{
+    std::string name = snapshot;
+    if (name.empty())
+    {
+        std::vector<std::string> names = list(dest);
+        if (names.empty())
+            throw std::runtime_error("No snapshots in " + dest);
+        name = names.back();
+    }
+
+    // Rebuild every file before touching the data directory.
+    std::map<std::string, std::string> files;
+    for (const auto &file : load_snapshot(dest, name).files)
+    {
+        std::string &contents = files[file.path];
+        for (const auto &hash : file.chunks)
+        {
+            std::string compressed;
+            std::string path = chunk_path(dest, hash);
+            if (!DurableFile::read(path, compressed))
+                throw std::runtime_error("Missing backup chunk: " + path);
+
+            std::string piece = Compression::decompress(compressed, "backup chunk: " + path);
+            if (Sha256::hex(piece) != hash)
+                throw std::runtime_error("Corrupt backup chunk: " + path);
+            contents += piece;
+        }
+        if (contents.size() != file.size)
+            throw std::runtime_error("Corrupt backup of " + file.path);
+    }
+
+    std::string root = ConfigManager::get_config_dir();
+    WriteBatch batch;
+    for (const auto &path : list_data_files(dest))
+    {
+        if (!files.count(path))
+            DurableFile::remove(root + "/" + path);
+    }
+    for (const auto &[path, contents] : files)
+    {
+        std::string full_path = root + "/" + path;
+        fs::create_directories(fs::path(full_path).parent_path());
+        DurableFile::write(full_path, contents);
+    }
+
+    // The index describes the data that was just replaced.
+    if (DurableFile::exists(SearchIndex::get_index_path()))
+        DurableFile::remove(SearchIndex::get_index_path());
+    if (DurableFile::exists(SearchIndex::get_journal_path()))
+        DurableFile::remove(SearchIndex::get_journal_path());
+    batch.commit();
+
+    return name;
+}
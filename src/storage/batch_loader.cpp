@@ -0,0 +1,369 @@
+#include "storage/batch_loader.hpp"
+#include "storage/client_decoder.hpp"
+#include "storage/config.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/parallel.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define WLOG_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace fs = std::filesystem;
+
+struct ReadSlot
+{
+    std::string path;
+    std::string contents;
+    bool found = false;
+    bool missing = false;
+    bool sharded = false;
+};
+
+static bool read_fd_at(int fd, char *buf, size_t size, size_t offset)
+{
+    while (offset < size)
+    {
+        ssize_t n = pread(fd, buf + offset, size - offset, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        offset += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+#ifdef WLOG_HAVE_IO_URING
+class IoUring
+{
+public:
+    explicit IoUring(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0)
+            return;
+
+        sq_len_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_len_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap)
+            sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+
+        sq_ptr_ = map(sq_len_, IORING_OFF_SQ_RING);
+        cq_ptr_ = single_mmap ? sq_ptr_ : map(cq_len_, IORING_OFF_CQ_RING);
+        sqes_len_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe *>(map(sqes_len_, IORING_OFF_SQES));
+        if (!sq_ptr_ || !cq_ptr_ || !sqes_)
+        {
+            release();
+            return;
+        }
+
+        char *sq = static_cast<char *>(sq_ptr_);
+        sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+        char *cq = static_cast<char *>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        capacity_ = params.sq_entries;
+    }
+
+    ~IoUring()
+    {
+        release();
+    }
+
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+    unsigned capacity() const { return capacity_; }
+
+    void queue_read(int fd, char *buf, unsigned len, uint64_t user_data)
+    {
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe *sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buf);
+        sqe->len = len;
+        sqe->off = 0;
+        sqe->user_data = user_data;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        queued_++;
+    }
+
+    // Submits everything queued and blocks until all of it has completed.
+    bool run(const std::function<void(uint64_t, int)> &on_complete)
+    {
+        unsigned to_submit = queued_;
+        unsigned outstanding = queued_;
+        queued_ = 0;
+
+        while (to_submit > 0)
+        {
+            int ret = enter(to_submit, 0, 0);
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret <= 0)
+                return false;
+            to_submit -= static_cast<unsigned>(ret);
+        }
+
+        while (outstanding > 0)
+        {
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            if (head == tail)
+            {
+                if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                    return false;
+                continue;
+            }
+
+            for (; head != tail; head++, outstanding--)
+            {
+                const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+                on_complete(cqe.user_data, cqe.res);
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        }
+        return true;
+    }
+
+private:
+    void *map(size_t len, off_t offset)
+    {
+        void *ptr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd_, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    void release()
+    {
+        if (sqes_)
+            munmap(sqes_, sqes_len_);
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_)
+            munmap(cq_ptr_, cq_len_);
+        if (sq_ptr_)
+            munmap(sq_ptr_, sq_len_);
+        if (fd_ >= 0)
+            close(fd_);
+        sqes_ = nullptr;
+        cq_ptr_ = sq_ptr_ = nullptr;
+        fd_ = -1;
+    }
+
+    int fd_ = -1;
+    unsigned capacity_ = 0;
+    unsigned queued_ = 0;
+
+    void *sq_ptr_ = nullptr;
+    void *cq_ptr_ = nullptr;
+    size_t sq_len_ = 0;
+    size_t cq_len_ = 0;
+    size_t sqes_len_ = 0;
+
+    unsigned *sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned *sq_array_ = nullptr;
+    io_uring_sqe *sqes_ = nullptr;
+
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe *cqes_ = nullptr;
+};
+
+// Files are opened one ring's worth at a time, so a large batch never holds
+// more descriptors than that. Slots that fail to open for any reason other
+// than not existing are left for the caller to retry.
+static void read_with_io_uring(std::vector<ReadSlot> &slots)
+{
+    IoUring ring(64);
+    if (!ring.ok())
+        return;
+
+    std::vector<size_t> todo;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        if (!slots[i].found && !slots[i].sharded)
+            todo.push_back(i);
+    }
+
+    struct Job
+    {
+        size_t slot;
+        int fd;
+    };
+
+    std::vector<Job> jobs;
+    bool ring_ok = true;
+    for (size_t start = 0; start < todo.size(); start += ring.capacity())
+    {
+        size_t end = std::min(todo.size(), start + ring.capacity());
+
+        jobs.clear();
+        for (size_t k = start; k < end; k++)
+        {
+            ReadSlot &slot = slots[todo[k]];
+            int fd = open(slot.path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                slot.missing = errno == ENOENT;
+                continue;
+            }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0)
+            {
+                close(fd);
+                continue;
+            }
+
+            slot.contents.resize(static_cast<size_t>(st.st_size));
+            jobs.push_back({todo[k], fd});
+        }
+
+        if (ring_ok)
+        {
+            for (size_t j = 0; j < jobs.size(); j++)
+            {
+                std::string &contents = slots[jobs[j].slot].contents;
+                ring.queue_read(jobs[j].fd, contents.data(), static_cast<unsigned>(contents.size()), j);
+            }
+
+            ring_ok = ring.run([&](uint64_t j, int res) {
+                ReadSlot &slot = slots[jobs[j].slot];
+                size_t done = res > 0 ? static_cast<size_t>(res) : 0;
+                // Short or failed reads (e.g. kernels without IORING_OP_READ) finish with pread.
+                slot.found = read_fd_at(jobs[j].fd, slot.contents.data(), slot.contents.size(), done);
+            });
+        }
+
+        for (const Job &job : jobs)
+        {
+            if (!ring_ok)
+            {
+                ReadSlot &slot = slots[job.slot];
+                slot.found = read_fd_at(job.fd, slot.contents.data(), slot.contents.size(), 0);
+            }
+            close(job.fd);
+        }
+    }
+}
+#endif
+
+bool BatchLoader::io_uring_available()
+{
+#ifdef WLOG_HAVE_IO_URING
+    IoUring ring(1);
+    return ring.ok();
+#else
+    return false;
+#endif
+}
+
+std::vector<std::string> BatchLoader::list_client_ids()
+{
+    std::vector<std::string> ids;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(ConfigManager::get_clients_dir(), ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".json")
+        {
+            ids.push_back(entry.path().stem().string());
+        }
+        else if (entry.is_directory() && fs::exists(entry.path() / "meta.json"))
+        {
+            ids.push_back(entry.path().filename().string());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+std::map<std::string, ClientData> BatchLoader::load(const std::vector<std::string> &client_ids,
+                                                    unsigned threads)
+{
+    std::vector<ReadSlot> slots(client_ids.size());
+    for (size_t i = 0; i < client_ids.size(); i++)
+    {
+        slots[i].path = ClientManager::get_client_path(client_ids[i]);
+        slots[i].sharded = ClientManager::is_sharded(client_ids[i]);
+        if (!slots[i].sharded)
+            slots[i].found = DurableFile::read_pending(slots[i].path, slots[i].contents);
+    }
+
+#ifdef WLOG_HAVE_IO_URING
+    read_with_io_uring(slots);
+#endif
+
+    std::vector<ClientData> parsed(slots.size());
+    parallel_for(slots.size(), threads, [&](size_t i) {
+        ReadSlot &slot = slots[i];
+        if (slot.sharded)
+        {
+            parsed[i] = ClientManager::load(client_ids[i]);
+            slot.found = true;
+            return;
+        }
+
+        if (!slot.found && !slot.missing)
+            slot.found = DurableFile::read(slot.path, slot.contents);
+        if (!slot.found)
+        {
+            // A file that is there but can't be read (e.g. out of descriptors)
+            // must not pass for a client that doesn't exist.
+            if (!slot.missing && DurableFile::exists(slot.path))
+                throw std::runtime_error("Could not read " + slot.path);
+            return;
+        }
+
+        parsed[i] = ClientDecoder::decode_client(slot.contents);
+        std::string().swap(slot.contents);
+    });
+
+    // Messages repeat heavily across clients, so they share one pool.
+    auto pool = std::allocate_shared<MessagePool>(std::pmr::polymorphic_allocator<MessagePool>());
+    std::map<std::string, ClientData> clients;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        if (!slots[i].found)
+            continue;
+        parsed[i].logs.share_pool(pool);
+        clients.emplace(client_ids[i], std::move(parsed[i]));
+    }
+    return clients;
+}
+
+std::map<std::string, ClientData> BatchLoader::load_all(unsigned threads)
+{
+    return load(list_client_ids(), threads);
+}
@@ -1,102 +1,320 @@
 #include "storage/client.hpp"
+#include "storage/client_decoder.hpp"
+#include "storage/client_encoder.hpp"
 #include "storage/config.hpp"
-#include <fstream>
+#include "storage/data_root.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/registry.hpp"
+#include "storage/archive.hpp"
+#include "storage/search_index.hpp"
 #include <filesystem>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <set>
 
 namespace fs = std::filesystem;
 
+// Layout of the default root; bound roots carry their own.
+static ClientLayout layout = ClientLayout::SingleFile;
+
+static std::string year_of(const std::string &month_key)
+{
+    return month_key.substr(0, 4);
+}
+
+static std::string year_of(Calendar::Date date)
+{
+    return std::to_string(date.year());
+}
+
+static std::set<std::string> read_meta(const std::string &client_id, ClientData &data)
+{
+    std::string contents;
+    if (!DurableFile::read(ClientManager::get_meta_path(client_id), contents))
+    {
+        return {};
+    }
+
+    std::set<std::string> years;
+    data = ClientDecoder::decode_client(contents, &years);
+    return years;
+}
+
+static void write_meta(const std::string &client_id, const ClientData &data,
+                       const std::set<std::string> &years)
+{
+    DurableFile::write(ClientManager::get_meta_path(client_id), ClientEncoder::encode_meta(data, years));
+}
+
+static void read_shard(const std::string &client_id, const std::string &year, WorkLogTable &logs)
+{
+    std::string contents;
+    if (DurableFile::read(ClientManager::get_shard_path(client_id, year), contents))
+    {
+        logs.merge(ClientDecoder::decode_logs(contents));
+    }
+}
+
+static void write_shard(const std::string &client_id, const std::string &year, const WorkLogTable &logs)
+{
+    int y = std::stoi(year);
+    DurableFile::write(ClientManager::get_shard_path(client_id, year),
+                       ClientEncoder::encode_logs(logs.between(Calendar::Date(y, 1, 1), Calendar::Date(y, 12, 31))));
+}
+
+void ClientManager::set_layout(ClientLayout new_layout)
+{
+    if (DataRoot *root = DataRoot::current())
+        root->set_layout(new_layout);
+    else
+        layout = new_layout;
+}
+
+ClientLayout ClientManager::get_layout()
+{
+    if (DataRoot *root = DataRoot::current())
+        return root->layout();
+    return layout;
+}
+
 std::string ClientManager::get_client_path(const std::string &client_id)
 {
     return ConfigManager::get_clients_dir() + "/" + client_id + ".json";
 }
 
+std::string ClientManager::get_client_dir(const std::string &client_id)
+{
+    return ConfigManager::get_clients_dir() + "/" + client_id;
+}
+
+std::string ClientManager::get_meta_path(const std::string &client_id)
+{
+    return get_client_dir(client_id) + "/meta.json";
+}
+
+std::string ClientManager::get_shard_path(const std::string &client_id, const std::string &year)
+{
+    return get_client_dir(client_id) + "/" + year + ".json";
+}
+
 bool ClientManager::client_exists(const std::string &client_id)
 {
-    return fs::exists(get_client_path(client_id));
+    return DurableFile::exists(get_client_path(client_id)) || is_sharded(client_id);
+}
+
+bool ClientManager::is_sharded(const std::string &client_id)
+{
+    return DurableFile::exists(get_meta_path(client_id));
 }
 
 ClientData ClientManager::load(const std::string &client_id)
 {
-    std::ifstream file(get_client_path(client_id));
-    if (!file.is_open())
+    if (is_sharded(client_id))
+    {
+        ClientData data;
+        for (const auto &year : read_meta(client_id, data))
+        {
+            read_shard(client_id, year, data.logs);
+        }
+        return data;
+    }
+
+    std::string contents;
+    if (!DurableFile::read(get_client_path(client_id), contents))
     {
         return ClientData{};
     }
 
-    nlohmann::json j;
-    file >> j;
-    return j.get<ClientData>();
+    return ClientDecoder::decode_client(contents);
 }
 
-void ClientManager::save(const std::string &client_id, const ClientData &data)
+ClientData ClientManager::load(const std::string &client_id, const std::string &month_key)
 {
-    ConfigManager::ensure_directories();
+    Calendar::Date month = Calendar::parse_month(month_key);
+    return load(client_id, month.month_start(), month.month_end());
+}
 
-    std::ofstream file(get_client_path(client_id));
-    if (!file.is_open())
+ClientData ClientManager::load(const std::string &client_id, Calendar::Date from, Calendar::Date to)
+{
+    ClientData data;
+    if (is_sharded(client_id))
     {
-        throw std::runtime_error("Could not open client file for writing");
+        for (const auto &year : read_meta(client_id, data))
+        {
+            int y = std::stoi(year);
+            if (y >= from.year() && y <= to.year())
+            {
+                read_shard(client_id, year, data.logs);
+            }
+        }
+    }
+    else
+    {
+        data = load(client_id);
     }
 
-    nlohmann::json j = data;
-    file << j.dump(2);
+    merge_archive(client_id, data, from, to);
+    return data;
 }
 
-void ClientManager::add_work_log(const std::string &client_id,
-                                  const std::string &date,
-                                  double hours,
-                                  const std::string &message)
+void ClientManager::merge_archive(const std::string &client_id, ClientData &data, Calendar::Date from,
+                                  Calendar::Date to)
 {
-    ClientData data = load(client_id);
+    auto archived = data.archived_months.lower_bound(Calendar::month_key(from).str());
+    if (archived != data.archived_months.end() && *archived <= Calendar::month_key(to).view())
+    {
+        // Entries logged after archiving take precedence.
+        data.logs.merge(ArchiveManager::load(client_id).slice(from, to), false);
+    }
+}
 
-    std::string month_key = date.substr(0, 7);
+void ClientManager::save(const std::string &client_id, const ClientData &data)
+{
+    ConfigManager::ensure_directories();
 
-    data.logs[month_key][date] = WorkLog{hours, message};
+    bool sharded = is_sharded(client_id);
+    if (sharded || get_layout() == ClientLayout::Sharded)
+    {
+        fs::create_directories(get_client_dir(client_id));
 
-    save(client_id, data);
+        std::set<std::string> old_years;
+        if (sharded)
+        {
+            ClientData existing;
+            old_years = read_meta(client_id, existing);
+        }
+
+        std::set<std::string> years;
+        for (Calendar::Date month : data.logs.months())
+        {
+            std::string year = year_of(month);
+            if (years.insert(year).second)
+            {
+                write_shard(client_id, year, data.logs);
+            }
+        }
+
+        // Meta goes last so an interrupted migration leaves the single file in charge.
+        write_meta(client_id, data, years);
+
+        for (const auto &year : old_years)
+        {
+            if (!years.count(year))
+                DurableFile::remove(get_shard_path(client_id, year));
+        }
+        if (!sharded)
+        {
+            DurableFile::remove(get_client_path(client_id));
+        }
+    }
+    else
+    {
+        DurableFile::write(get_client_path(client_id), ClientEncoder::encode_client(data));
+    }
+
+    ClientRegistry::update(client_id, data);
 }
 
-double ClientManager::get_month_total_hours(const ClientData &client,
-                                             const std::string &month_key)
+ClientData ClientManager::load_years(const std::string &client_id, const std::set<std::string> &years)
+{
+    if (!is_sharded(client_id))
+        return load(client_id);
+
+    ClientData data;
+    for (const auto &year : read_meta(client_id, data))
+    {
+        if (years.count(year))
+            read_shard(client_id, year, data.logs);
+    }
+    return data;
+}
+
+void ClientManager::save_years(const std::string &client_id, const ClientData &data,
+                               const std::set<std::string> &years)
 {
-    double total = 0.0;
-    auto it = client.logs.find(month_key);
-    if (it != client.logs.end())
+    if (!is_sharded(client_id))
     {
-        for (const auto &[date, log] : it->second)
+        save(client_id, data);
+        return;
+    }
+
+    ClientData existing;
+    std::set<std::string> kept = read_meta(client_id, existing);
+    std::set<std::string> emptied;
+    for (const auto &year : years)
+    {
+        int y = std::stoi(year);
+        if (data.logs.between(Calendar::Date(y, 1, 1), Calendar::Date(y, 12, 31)).empty())
         {
-            total += log.hours;
+            if (kept.erase(year))
+                emptied.insert(year);
+            continue;
         }
+        write_shard(client_id, year, data.logs);
+        kept.insert(year);
     }
-    return total;
+
+    write_meta(client_id, data, kept);
+    for (const auto &year : emptied)
+        DurableFile::remove(get_shard_path(client_id, year));
+
+    ClientRegistry::update(client_id, data);
 }
 
-std::string ClientManager::get_previous_month_key()
+void ClientManager::add_work_log(const std::string &client_id,
+                                  const std::string &date,
+                                  double hours,
+                                  const std::string &message)
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&now_time);
+    std::string month_key = date.substr(0, 7);
 
-    if (tm.tm_mon == 0)
+    if (!is_sharded(client_id))
     {
-        tm.tm_year--;
-        tm.tm_mon = 11;
+        ClientData data = load(client_id);
+        data.logs.set(date, hours, message);
+        save(client_id, data);
+        SearchIndex::record(client_id, Calendar::parse_stored_date(date), hours, message);
+        return;
     }
-    else
+
+    std::string year = year_of(month_key);
+    WorkLogTable logs;
+    read_shard(client_id, year, logs);
+    logs.set(date, hours, message);
+    write_shard(client_id, year, logs);
+
+    ClientData meta;
+    std::set<std::string> years = read_meta(client_id, meta);
+    if (years.insert(year).second)
     {
-        tm.tm_mon--;
+        write_meta(client_id, meta, years);
     }
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m");
-    return oss.str();
+    ClientRegistry::record_activity(client_id, month_key);
+    SearchIndex::record(client_id, Calendar::parse_stored_date(date), hours, message);
+}
+
+double ClientManager::get_month_total_hours(const ClientData &client,
+                                             const std::string &month_key)
+{
+    return client.logs.month(month_key).total_hours();
+}
+
+std::string ClientManager::get_previous_month_key()
+{
+    return Calendar::month_key(Calendar::add_months(Calendar::today(), -1)).str();
 }
 
 int ClientManager::increment_invoice_number(const std::string &client_id)
 {
+    if (is_sharded(client_id))
+    {
+        ClientData meta;
+        std::set<std::string> years = read_meta(client_id, meta);
+        int invoice_num = meta.next_invoice_number;
+        meta.next_invoice_number++;
+        write_meta(client_id, meta, years);
+        return invoice_num;
+    }
+
     ClientData data = load(client_id);
     int invoice_num = data.next_invoice_number;
     data.next_invoice_number++;
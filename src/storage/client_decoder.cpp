@@ -0,0 +1,180 @@
+#include "storage/client_decoder.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#ifdef WLOG_HAVE_SIMDJSON
+#include <simdjson.h>
+
+namespace od = simdjson::ondemand;
+
+// An indexed message seen before the file's "messages" list, which sorts last.
+struct IndexedEntry
+{
+    Calendar::Date date;
+    double hours;
+    uint64_t index;
+};
+
+static od::parser &parser()
+{
+    static thread_local od::parser instance;
+    return instance;
+}
+
+static simdjson::simdjson_result<od::document> iterate(std::string &contents)
+{
+    size_t size = contents.size();
+    contents.reserve(size + simdjson::SIMDJSON_PADDING);
+    return parser().iterate(contents.data(), size, contents.capacity());
+}
+
+static std::string string_of(od::value value)
+{
+    return std::string(std::string_view(value.get_string()));
+}
+
+static void decode_entries(od::object logs, WorkLogTable &table)
+{
+    std::vector<std::string_view> messages;
+    std::vector<IndexedEntry> indexed;
+
+    for (auto month : logs)
+    {
+        if (std::string_view(month.unescaped_key()) == "messages")
+        {
+            for (auto message : month.value().get_array())
+                messages.push_back(message.get_string());
+            continue;
+        }
+
+        for (auto day : month.value().get_object())
+        {
+            std::string_view key = day.unescaped_key();
+            Calendar::Date date = Calendar::parse_stored_date(key);
+            if (!date.valid())
+                throw std::runtime_error("Invalid work log date: " + std::string(key));
+
+            double hours = 0.0;
+            std::string_view message;
+            bool has_index = false;
+            uint64_t index = 0;
+            for (auto field : day.value().get_object())
+            {
+                std::string_view name = field.unescaped_key();
+                od::value value = field.value();
+                if (name == "hours")
+                {
+                    hours = value.get_double();
+                }
+                else if (name == "message")
+                {
+                    if (value.type() == od::json_type::number)
+                    {
+                        index = value.get_uint64();
+                        has_index = true;
+                    }
+                    else
+                    {
+                        message = value.get_string();
+                    }
+                }
+            }
+
+            if (has_index)
+                indexed.push_back({date, hours, index});
+            else
+                table.set(date, hours, message);
+        }
+    }
+
+    for (const IndexedEntry &entry : indexed)
+    {
+        if (entry.index >= messages.size())
+            throw std::runtime_error("Work log message index out of range: " + std::to_string(entry.index));
+        table.set(entry.date, entry.hours, messages[entry.index]);
+    }
+}
+#endif
+
+static bool on_demand = false;
+
+void ClientDecoder::set_on_demand(bool enabled)
+{
+    on_demand = enabled;
+}
+
+bool ClientDecoder::get_on_demand()
+{
+    return on_demand && available();
+}
+
+bool ClientDecoder::available()
+{
+#ifdef WLOG_HAVE_SIMDJSON
+    return true;
+#else
+    return false;
+#endif
+}
+
+ClientData ClientDecoder::decode_client(std::string &contents, std::set<std::string> *shards)
+{
+#ifdef WLOG_HAVE_SIMDJSON
+    if (get_on_demand())
+    {
+        ClientData data;
+        od::document doc = iterate(contents);
+        for (auto field : doc.get_object())
+        {
+            std::string_view key = field.unescaped_key();
+            od::value value = field.value();
+            if (key == "name")
+                data.name = string_of(value);
+            else if (key == "address_line1")
+                data.address_line1 = string_of(value);
+            else if (key == "address_line2")
+                data.address_line2 = string_of(value);
+            else if (key == "hourly_rate")
+                data.hourly_rate = value.get_double();
+            else if (key == "payment_term_days")
+                data.payment_term_days = static_cast<int>(int64_t(value.get_int64()));
+            else if (key == "tag")
+                data.tag = string_of(value);
+            else if (key == "next_invoice_number")
+                data.next_invoice_number = static_cast<int>(int64_t(value.get_int64()));
+            else if (key == "logs")
+                decode_entries(value.get_object(), data.logs);
+            else if (key == "archived_months")
+                for (auto month : value.get_array())
+                    data.archived_months.emplace(std::string_view(month.get_string()));
+            else if (key == "shards" && shards)
+                for (auto year : value.get_array())
+                    shards->emplace(std::string_view(year.get_string()));
+        }
+        return data;
+    }
+#endif
+
+    nlohmann::json j = nlohmann::json::parse(contents);
+    if (shards)
+        *shards = j.value("shards", std::set<std::string>{});
+    j.erase("shards");
+    return j.get<ClientData>();
+}
+
+WorkLogTable ClientDecoder::decode_logs(std::string &contents)
+{
+#ifdef WLOG_HAVE_SIMDJSON
+    if (get_on_demand())
+    {
+        WorkLogTable table;
+        od::document doc = iterate(contents);
+        decode_entries(doc.get_object(), table);
+        return table;
+    }
+#endif
+
+    return nlohmann::json::parse(contents).get<WorkLogTable>();
+}
@@ -0,0 +1,314 @@
+#include "storage/client_encoder.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Rough bytes per log row in pretty output, to size the buffer up front.
+static constexpr size_t ROW_BYTES = 96;
+
+static JsonFormat format = JsonFormat::Pretty;
+
+// Appends JSON to a string in the layout nlohmann's dump() produces: keys as
+// given (callers emit them sorted), two-space indents when pretty.
+class JsonWriter
+{
+public:
+    JsonWriter(std::string &out, JsonFormat format) : out_(out), pretty_(format == JsonFormat::Pretty) {}
+
+    void begin_object() { open('{'); }
+    void end_object() { close('}'); }
+    void begin_array() { open('['); }
+    void end_array() { close(']'); }
+
+    void key(std::string_view name)
+    {
+        element();
+        string(name);
+        out_.append(pretty_ ? ": " : ":");
+        after_key_ = true;
+    }
+
+    void value(std::string_view text)
+    {
+        element();
+        string(text);
+    }
+
+    void value(uint64_t number)
+    {
+        element();
+        char buffer[24];
+        out_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), number).ptr);
+    }
+
+    void value(int number)
+    {
+        element();
+        char buffer[16];
+        out_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), number).ptr);
+    }
+
+    void value(double number)
+    {
+        element();
+        if (!std::isfinite(number))
+        {
+            out_.append("null");
+            return;
+        }
+
+        char buffer[32];
+        char *end = std::to_chars(buffer, buffer + sizeof(buffer), number).ptr;
+        out_.append(buffer, end);
+        if (std::string_view(buffer, end - buffer).find_first_of(".e") == std::string_view::npos)
+            out_.append(".0");
+    }
+
+private:
+    void open(char bracket)
+    {
+        element();
+        out_.push_back(bracket);
+        counts_.push_back(0);
+    }
+
+    void close(char bracket)
+    {
+        size_t count = counts_.back();
+        counts_.pop_back();
+        if (count > 0)
+            newline();
+        out_.push_back(bracket);
+    }
+
+    // Separates a new element from the previous one in its container.
+    void element()
+    {
+        if (after_key_)
+        {
+            after_key_ = false;
+            return;
+        }
+        if (counts_.empty())
+            return;
+        if (counts_.back()++ > 0)
+            out_.push_back(',');
+        newline();
+    }
+
+    void newline()
+    {
+        if (!pretty_)
+            return;
+        out_.push_back('\n');
+        out_.append(counts_.size() * 2, ' ');
+    }
+
+    void string(std::string_view text)
+    {
+        static const char *const HEX = "0123456789abcdef";
+
+        out_.push_back('"');
+        size_t i = 0;
+        while (i < text.size())
+        {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x80)
+            {
+                size_t length = utf8_length(text, i);
+                out_.append(text.substr(i, length));
+                i += length;
+                continue;
+            }
+
+            switch (c)
+            {
+            case '"': out_.append("\\\""); break;
+            case '\\': out_.append("\\\\"); break;
+            case '\b': out_.append("\\b"); break;
+            case '\f': out_.append("\\f"); break;
+            case '\n': out_.append("\\n"); break;
+            case '\r': out_.append("\\r"); break;
+            case '\t': out_.append("\\t"); break;
+            default:
+                if (c < 0x20)
+                {
+                    out_.append("\\u00");
+                    out_.push_back(HEX[c >> 4]);
+                    out_.push_back(HEX[c & 0xf]);
+                }
+                else
+                {
+                    out_.push_back(static_cast<char>(c));
+                }
+            }
+            i++;
+        }
+        out_.push_back('"');
+    }
+
+    // Length of the multi-byte sequence at i; throws on invalid UTF-8, which
+    // neither loader would read back.
+    static size_t utf8_length(std::string_view text, size_t i)
+    {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead >= 0xf5 ? 0 : lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc2 ? 2 : 0;
+        if (length == 0 || i + length > text.size())
+            throw std::runtime_error("Invalid UTF-8 in client data");
+
+        uint32_t code = lead & (0x7f >> length);
+        for (size_t k = 1; k < length; k++)
+        {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xc0) != 0x80)
+                throw std::runtime_error("Invalid UTF-8 in client data");
+            code = (code << 6) | (next & 0x3f);
+        }
+
+        static const uint32_t MIN_CODE[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (code < MIN_CODE[length] || code > 0x10ffff || (code >= 0xd800 && code <= 0xdfff))
+            throw std::runtime_error("Invalid UTF-8 in client data");
+        return length;
+    }
+
+    std::string &out_;
+    bool pretty_;
+    bool after_key_ = false;
+    std::vector<size_t> counts_;
+};
+
+static void write_strings(JsonWriter &writer, const std::set<std::string> &strings)
+{
+    writer.begin_array();
+    for (const auto &text : strings)
+        writer.value(text);
+    writer.end_array();
+}
+
+static void write_logs(JsonWriter &writer, WorkLogTable::Range rows)
+{
+    bool dictionary = WorkLogTable::get_encoding() == MessageEncoding::Dictionary;
+    std::unordered_map<std::string_view, uint64_t> indices;
+    std::vector<std::string_view> messages;
+
+    writer.begin_object();
+    Calendar::Date current_month;
+    bool in_month = false;
+    for (const auto &row : rows)
+    {
+        if (!in_month || row.date.month_start() != current_month)
+        {
+            if (in_month)
+                writer.end_object();
+            current_month = row.date.month_start();
+            in_month = true;
+            writer.key(Calendar::month_key(row.date).view());
+            writer.begin_object();
+        }
+
+        writer.key(Calendar::iso(row.date).view());
+        writer.begin_object();
+        writer.key("hours");
+        writer.value(row.hours);
+        writer.key("message");
+        if (dictionary)
+        {
+            auto [it, inserted] = indices.emplace(row.message, messages.size());
+            if (inserted)
+                messages.push_back(row.message);
+            writer.value(it->second);
+        }
+        else
+        {
+            writer.value(row.message);
+        }
+        writer.end_object();
+    }
+    if (in_month)
+        writer.end_object();
+
+    if (!messages.empty())
+    {
+        writer.key("messages");
+        writer.begin_array();
+        for (std::string_view message : messages)
+            writer.value(message);
+        writer.end_array();
+    }
+    writer.end_object();
+}
+
+// Fields in the sorted order nlohmann keeps them in. Logs are left out when
+// rows is null; shards only appear when given.
+static std::string write_client(const ClientData &data, const WorkLogTable::Range *rows,
+                                const std::set<std::string> *shards, JsonFormat json_format)
+{
+    std::string out;
+    out.reserve(512 + (rows ? rows->size() * ROW_BYTES : 0));
+    JsonWriter writer(out, json_format);
+
+    writer.begin_object();
+    writer.key("address_line1");
+    writer.value(data.address_line1);
+    writer.key("address_line2");
+    writer.value(data.address_line2);
+    writer.key("archived_months");
+    write_strings(writer, data.archived_months);
+    writer.key("hourly_rate");
+    writer.value(data.hourly_rate);
+    if (rows)
+    {
+        writer.key("logs");
+        write_logs(writer, *rows);
+    }
+    writer.key("name");
+    writer.value(data.name);
+    writer.key("next_invoice_number");
+    writer.value(data.next_invoice_number);
+    writer.key("payment_term_days");
+    writer.value(data.payment_term_days);
+    if (shards)
+    {
+        writer.key("shards");
+        write_strings(writer, *shards);
+    }
+    writer.key("tag");
+    writer.value(data.tag);
+    writer.end_object();
+    return out;
+}
+
+void ClientEncoder::set_format(JsonFormat value)
+{
+    format = value;
+}
+
+JsonFormat ClientEncoder::get_format()
+{
+    return format;
+}
+
+std::string ClientEncoder::encode_client(const ClientData &data, JsonFormat json_format)
+{
+    WorkLogTable::Range rows = data.logs.all();
+    return write_client(data, &rows, nullptr, json_format);
+}
+
+std::string ClientEncoder::encode_meta(const ClientData &data, const std::set<std::string> &shards,
+                                       JsonFormat json_format)
+{
+    return write_client(data, nullptr, &shards, json_format);
+}
+
+std::string ClientEncoder::encode_logs(WorkLogTable::Range rows, JsonFormat json_format)
+{
+    std::string out;
+    out.reserve(16 + rows.size() * ROW_BYTES);
+    JsonWriter writer(out, json_format);
+    write_logs(writer, rows);
+    return out;
+}
@@ -0,0 +1,33 @@
+#include "storage/compression.hpp"
+#include <stdexcept>
+#include <zstd.h>
+
+std::string Compression::compress(std::string_view input, int level)
+{
+    std::string output(ZSTD_compressBound(input.size()), '\0');
+    size_t size = ZSTD_compress(output.data(), output.size(), input.data(), input.size(), level);
+    if (ZSTD_isError(size))
+    {
+        throw std::runtime_error(std::string("Could not compress: ") + ZSTD_getErrorName(size));
+    }
+    output.resize(size);
+    return output;
+}
+
+std::string Compression::decompress(std::string_view input, const std::string &what)
+{
+    unsigned long long content_size = ZSTD_getFrameContentSize(input.data(), input.size());
+    if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN)
+    {
+        throw std::runtime_error("Corrupt " + what);
+    }
+
+    std::string output(content_size, '\0');
+    size_t size = ZSTD_decompress(output.data(), output.size(), input.data(), input.size());
+    if (ZSTD_isError(size))
+    {
+        throw std::runtime_error("Corrupt " + what);
+    }
+    output.resize(size);
+    return output;
+}
@@ -1,5 +1,8 @@
 #include "storage/config.hpp"
-#include <fstream>
+#include "storage/data_root.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/client.hpp"
+#include "storage/client_encoder.hpp"
 #include <cstdlib>
 #include <filesystem>
 
@@ -7,6 +10,9 @@ namespace fs = std::filesystem;
 
 std::string ConfigManager::get_config_dir()
 {
+    if (DataRoot *root = DataRoot::current())
+        return root->dir();
+
     const char *home = std::getenv("HOME");
     if (!home)
     {
@@ -32,7 +38,7 @@ std::string ConfigManager::get_logos_dir()
 
 bool ConfigManager::config_exists()
 {
-    return fs::exists(get_config_path());
+    return DurableFile::exists(get_config_path());
 }
 
 void ConfigManager::ensure_directories()
@@ -44,27 +50,27 @@ void ConfigManager::ensure_directories()
 
 AppConfig ConfigManager::load()
 {
-    std::ifstream file(get_config_path());
-    if (!file.is_open())
+    std::string contents;
+    if (!DurableFile::read(get_config_path(), contents))
     {
         return AppConfig{};
     }
 
-    nlohmann::json j;
-    file >> j;
-    return j.get<AppConfig>();
+    return nlohmann::json::parse(contents).get<AppConfig>();
 }
 
 void ConfigManager::save(const AppConfig &config)
 {
     ensure_directories();
 
-    std::ofstream file(get_config_path());
-    if (!file.is_open())
-    {
-        throw std::runtime_error("Could not open config file for writing");
-    }
-
     nlohmann::json j = config;
-    file << j.dump(2);
+    DurableFile::write(get_config_path(), j.dump(2));
+}
+
+void ConfigManager::apply_storage_config(const StorageConfig &storage)
+{
+    DurableFile::set_policy(storage.durability);
+    ClientManager::set_layout(storage.layout);
+    WorkLogTable::set_encoding(storage.message_encoding);
+    ClientEncoder::set_format(storage.json_format);
 }
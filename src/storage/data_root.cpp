@@ -0,0 +1,22 @@
+#include "storage/data_root.hpp"
+
+static thread_local DataRoot *bound = nullptr;
+
+DataRoot::DataRoot(std::string dir, ClientLayout layout) : dir_(std::move(dir)), layout_(layout)
+{
+}
+
+DataRoot::Scope::Scope(DataRoot *root) : previous_(bound)
+{
+    bound = root;
+}
+
+DataRoot::Scope::~Scope()
+{
+    bound = previous_;
+}
+
+DataRoot *DataRoot::current()
+{
+    return bound;
+}
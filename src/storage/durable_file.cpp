@@ -0,0 +1,322 @@
+#include "storage/durable_file.hpp"
+#include <fstream>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+static DurabilityPolicy policy = DurabilityPolicy::PerBatch;
+// Batches belong to the thread that opened them, so threads serving
+// different data roots commit independently. Pending writes are visible to
+// readers on every thread.
+static thread_local int batch_depth = 0;
+static thread_local std::vector<std::function<void(bool)>> finish_hooks;
+
+struct PendingWrite
+{
+    // Without a value the entry is a removal.
+    std::optional<std::string> contents;
+    std::thread::id owner;
+};
+
+static std::map<std::string, PendingWrite> pending;
+static std::mutex pending_mutex;
+
+static bool sync_fd(int fd)
+{
+#ifdef __APPLE__
+    // fsync on macOS does not flush the drive cache
+    if (fcntl(fd, F_FULLFSYNC) == 0)
+        return true;
+#endif
+    return fsync(fd) == 0;
+}
+
+// Each write gets its own temp file, so processes saving the same file at
+// once never write into each other's. The .tmp suffix keeps it out of the
+// watcher and backups.
+static std::string write_temp(const std::string &path, const std::string &contents, bool sync)
+{
+    std::string tmp = path + ".XXXXXX.tmp";
+    int fd = mkstemps(tmp.data(), 4);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not create a temp file for " + path);
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    fchmod(fd, 0644);
+
+    const char *data = contents.data();
+    size_t remaining = contents.size();
+    while (remaining > 0)
+    {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            unlink(tmp.c_str());
+            throw std::runtime_error("Could not write " + tmp);
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (sync && !sync_fd(fd))
+    {
+        close(fd);
+        unlink(tmp.c_str());
+        throw std::runtime_error("Could not sync " + tmp);
+    }
+
+    close(fd);
+    return tmp;
+}
+
+static void replace_file(const std::string &tmp, const std::string &path)
+{
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        throw std::runtime_error("Could not replace " + path);
+    }
+}
+
+static std::string parent_dir(const std::string &path)
+{
+    std::string dir = fs::path(path).parent_path().string();
+    return dir.empty() ? "." : dir;
+}
+
+enum class PendingState
+{
+    None,
+    Written,
+    Removed
+};
+
+static PendingState lookup_pending(const std::string &path, std::string *contents)
+{
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    auto it = pending.find(path);
+    if (it == pending.end())
+        return PendingState::None;
+    if (!it->second.contents)
+        return PendingState::Removed;
+    if (contents)
+        *contents = *it->second.contents;
+    return PendingState::Written;
+}
+
+static void sync_directory(const std::string &dir)
+{
+    // Best effort: some filesystems refuse fsync on directories.
+    int fd = open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    sync_fd(fd);
+    close(fd);
+}
+
+void DurableFile::set_policy(DurabilityPolicy new_policy)
+{
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    policy = new_policy;
+}
+
+DurabilityPolicy DurableFile::get_policy()
+{
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    return policy;
+}
+
+void DurableFile::write(const std::string &path, const std::string &contents)
+{
+    bool sync;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        if (batch_depth > 0 && policy == DurabilityPolicy::PerBatch)
+        {
+            pending[path] = {contents, std::this_thread::get_id()};
+            return;
+        }
+        sync = policy != DurabilityPolicy::None;
+    }
+
+    std::string tmp = write_temp(path, contents, sync);
+    replace_file(tmp, path);
+    if (sync)
+    {
+        sync_directory(parent_dir(path));
+    }
+}
+
+void DurableFile::remove(const std::string &path)
+{
+    bool sync;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        if (batch_depth > 0 && policy == DurabilityPolicy::PerBatch)
+        {
+            pending[path] = {std::nullopt, std::this_thread::get_id()};
+            return;
+        }
+        sync = policy != DurabilityPolicy::None;
+    }
+
+    std::error_code ec;
+    if (fs::remove(path, ec) && sync)
+    {
+        sync_directory(parent_dir(path));
+    }
+}
+
+bool DurableFile::read_pending(const std::string &path, std::string &contents)
+{
+    return lookup_pending(path, &contents) == PendingState::Written;
+}
+
+bool DurableFile::read(const std::string &path, std::string &contents)
+{
+    PendingState state = lookup_pending(path, &contents);
+    if (state != PendingState::None)
+    {
+        return state == PendingState::Written;
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    contents.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return true;
+}
+
+bool DurableFile::exists(const std::string &path)
+{
+    PendingState state = lookup_pending(path, nullptr);
+    if (state != PendingState::None)
+    {
+        return state == PendingState::Written;
+    }
+    return fs::exists(path);
+}
+
+WriteBatch::WriteBatch()
+{
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    owner_ = batch_depth == 0;
+    batch_depth++;
+}
+
+static void discard_own_pending()
+{
+    std::thread::id self = std::this_thread::get_id();
+    for (auto it = pending.begin(); it != pending.end();)
+        it = it->second.owner == self ? pending.erase(it) : std::next(it);
+}
+
+static void run_finish_hooks(bool committed)
+{
+    std::vector<std::function<void(bool)>> hooks;
+    hooks.swap(finish_hooks);
+    for (const auto &hook : hooks)
+        hook(committed);
+}
+
+WriteBatch::~WriteBatch()
+{
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        batch_depth--;
+        if (owner_)
+        {
+            discard_own_pending();
+        }
+    }
+    if (owner_)
+        run_finish_hooks(false);
+}
+
+bool WriteBatch::active()
+{
+    return batch_depth > 0;
+}
+
+void WriteBatch::on_finish(std::function<void(bool committed)> fn)
+{
+    finish_hooks.push_back(std::move(fn));
+}
+
+void WriteBatch::commit()
+{
+    if (!owner_)
+        return;
+
+    run_finish_hooks(true);
+
+    // Copied out so the fsyncs below don't hold up readers on other threads,
+    // which keep seeing the pending contents until they are discarded.
+    std::thread::id self = std::this_thread::get_id();
+    std::map<std::string, std::optional<std::string>> writes;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        for (const auto &[path, write] : pending)
+        {
+            if (write.owner == self)
+                writes[path] = write.contents;
+        }
+    }
+
+    std::map<std::string, std::string> temps;
+    std::set<std::string> dirs;
+    try
+    {
+        for (const auto &[path, contents] : writes)
+        {
+            if (contents)
+                temps[path] = write_temp(path, *contents, true);
+        }
+        for (auto it = temps.begin(); it != temps.end(); it = temps.erase(it))
+        {
+            replace_file(it->second, it->first);
+            dirs.insert(parent_dir(it->first));
+        }
+    }
+    catch (...)
+    {
+        for (const auto &[path, tmp] : temps)
+            unlink(tmp.c_str());
+        throw;
+    }
+
+    for (const auto &[path, contents] : writes)
+    {
+        std::error_code ec;
+        if (!contents && fs::remove(path, ec))
+            dirs.insert(parent_dir(path));
+    }
+
+    for (const auto &dir : dirs)
+    {
+        sync_directory(dir);
+    }
+
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    discard_own_pending();
+}
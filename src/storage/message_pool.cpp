@@ -0,0 +1,16 @@
+#include "storage/message_pool.hpp"
+
+uint32_t MessagePool::intern(std::string_view message)
+{
+    auto it = ids_.find(message);
+    if (it != ids_.end())
+    {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    const std::pmr::string &stored = strings_.emplace_back(message);
+    ids_.emplace(stored, id);
+    text_bytes_ += stored.size();
+    return id;
+}
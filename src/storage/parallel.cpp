@@ -0,0 +1,56 @@
+#include "storage/parallel.hpp"
+#include "storage/data_root.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void parallel_for(size_t count, unsigned threads, const std::function<void(size_t)> &fn)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+
+    if (threads <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    // Workers act on the caller's data root.
+    DataRoot *root = DataRoot::current();
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&]() {
+            DataRoot::Scope scope(root);
+            for (size_t i = next++; i < count; i = next++)
+            {
+                try
+                {
+                    fn(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        });
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,146 @@
+#include "storage/registry.hpp"
+#include "storage/config.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/durable_file.hpp"
+#include <algorithm>
+#include <functional>
+#include <optional>
+
+// Inside a WriteBatch the registry is read once and written back once when
+// the batch commits, rather than on every client save.
+struct BatchRegistry
+{
+    std::string path;
+    std::map<std::string, ClientSummary> registry;
+    bool dirty = false;
+};
+
+static thread_local std::optional<BatchRegistry> batch_registry;
+
+static void save_registry(const std::string &path, const std::map<std::string, ClientSummary> &registry)
+{
+    nlohmann::json j = registry;
+    DurableFile::write(path, j.dump(2));
+}
+
+static BatchRegistry *cached_registry(const std::string &path)
+{
+    return batch_registry && batch_registry->path == path ? &*batch_registry : nullptr;
+}
+
+// Applies change to the registry and saves it if change returns true.
+static void modify(const std::function<bool(std::map<std::string, ClientSummary> &)> &change)
+{
+    std::string path = ClientRegistry::get_registry_path();
+    if (BatchRegistry *cached = cached_registry(path))
+    {
+        if (change(cached->registry))
+            cached->dirty = true;
+        return;
+    }
+
+    // A rebuild only sees clients already on disk, not ones pending in a batch.
+    std::map<std::string, ClientSummary> registry =
+        DurableFile::exists(path) ? ClientRegistry::load() : ClientRegistry::rebuild();
+
+    if (WriteBatch::active() && !batch_registry)
+    {
+        batch_registry = BatchRegistry{path, std::move(registry)};
+        WriteBatch::on_finish([](bool committed) {
+            if (committed && batch_registry->dirty)
+                save_registry(batch_registry->path, batch_registry->registry);
+            batch_registry.reset();
+        });
+        modify(change);
+        return;
+    }
+
+    if (change(registry))
+        save_registry(path, registry);
+}
+
+std::string ClientRegistry::get_registry_path()
+{
+    return ConfigManager::get_config_dir() + "/registry.json";
+}
+
+std::map<std::string, ClientSummary> ClientRegistry::load()
+{
+    if (const BatchRegistry *cached = cached_registry(get_registry_path()))
+        return cached->registry;
+
+    std::string contents;
+    if (!DurableFile::read(get_registry_path(), contents))
+    {
+        return rebuild();
+    }
+
+    return nlohmann::json::parse(contents).get<std::map<std::string, ClientSummary>>();
+}
+
+std::map<std::string, ClientSummary> ClientRegistry::rebuild()
+{
+    std::map<std::string, ClientSummary> registry;
+    for (const auto &[id, data] : BatchLoader::load_all())
+    {
+        registry[id] = summarize(data);
+    }
+
+    ConfigManager::ensure_directories();
+    save_registry(get_registry_path(), registry);
+    if (BatchRegistry *cached = cached_registry(get_registry_path()))
+        *cached = BatchRegistry{cached->path, registry};
+    return registry;
+}
+
+ClientSummary ClientRegistry::summarize(const ClientData &data)
+{
+    ClientSummary summary;
+    summary.name = data.name;
+    summary.tag = data.tag;
+    summary.hourly_rate = data.hourly_rate;
+
+    if (!data.logs.empty())
+    {
+        summary.last_month = Calendar::month_key(data.logs.last_date()).str();
+    }
+    return summary;
+}
+
+void ClientRegistry::update(const std::string &client_id, const ClientData &data)
+{
+    ClientSummary summary = summarize(data);
+    modify([&](std::map<std::string, ClientSummary> &registry) {
+        auto it = registry.find(client_id);
+        if (it != registry.end())
+        {
+            // data may only hold some of the client's months
+            summary.last_month = std::max(summary.last_month, it->second.last_month);
+            if (it->second == summary)
+                return false;
+        }
+
+        registry[client_id] = summary;
+        return true;
+    });
+}
+
+void ClientRegistry::record_activity(const std::string &client_id, const std::string &month_key)
+{
+    modify([&](std::map<std::string, ClientSummary> &registry) {
+        auto it = registry.find(client_id);
+        if (it == registry.end())
+        {
+            registry[client_id] = summarize(ClientManager::load(client_id));
+        }
+        else if (it->second.last_month < month_key)
+        {
+            it->second.last_month = month_key;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    });
+}
@@ -0,0 +1,713 @@
+#include "storage/search_index.hpp"
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/archive.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/durable_file.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// search.idx layout (little-endian):
+//
+//   "WLOGIDX2"
+//   u32 clients, clients x (u32 length, bytes)
+//   u32 terms, u32 text size, u32 documents, u32 message size
+//   directory  terms x (u32 text offset, u32 length, u32 first posting, u32 postings), sorted by term
+//   documents  documents x (u64 key, f64 hours, u32 message offset, u32 length), sorted by key
+//   text       concatenated terms
+//   messages   concatenated messages
+//   postings   u64 keys, sorted within each term
+//
+// Keys pack (client index << 32 | yyyymmdd), so they order by client then date.
+static constexpr std::string_view INDEX_MAGIC = "WLOGIDX2";
+static constexpr size_t DIRECTORY_ENTRY = 16;
+static constexpr size_t DOCUMENT_ENTRY = 24;
+
+static uint64_t make_key(uint32_t client, uint32_t date)
+{
+    return static_cast<uint64_t>(client) << 32 | date;
+}
+
+static uint32_t key_client(uint64_t key)
+{
+    return static_cast<uint32_t>(key >> 32);
+}
+
+static Calendar::Date key_date(uint64_t key)
+{
+    return Calendar::Date(static_cast<uint32_t>(key));
+}
+
+static void append_u32(std::string &out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+static void append_u64(std::string &out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+static void check_bounds(size_t end, size_t size)
+{
+    if (end > size)
+        throw std::runtime_error("Corrupt search index: " + SearchIndex::get_index_path());
+}
+
+static uint64_t read_le(std::string_view data, size_t pos, int bytes)
+{
+    check_bounds(pos + bytes, data.size());
+
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+    return value;
+}
+
+static uint32_t read_u32(std::string_view data, size_t pos)
+{
+    return static_cast<uint32_t>(read_le(data, pos, 4));
+}
+
+struct Document
+{
+    double hours = 0.0;
+    std::string message;
+};
+
+// Postings are derived from the documents when serialized, so overwritten
+// entries never leave stale postings behind in the index file.
+class IndexBuilder
+{
+public:
+    uint32_t client(const std::string &client_id)
+    {
+        auto [it, inserted] = client_ids_.emplace(client_id, static_cast<uint32_t>(clients_.size()));
+        if (inserted)
+            clients_.push_back(client_id);
+        return it->second;
+    }
+
+    void add(uint32_t client, Calendar::Date date, double hours, std::string_view message)
+    {
+        documents_[make_key(client, date.value)] = {hours, std::string(message)};
+    }
+
+    void remove(uint32_t client, Calendar::Date from, Calendar::Date to)
+    {
+        documents_.erase(documents_.lower_bound(make_key(client, from.value)),
+                         documents_.upper_bound(make_key(client, to.value)));
+    }
+
+    std::string serialize() const
+    {
+        std::map<std::string, std::vector<uint64_t>> postings;
+        std::string documents;
+        std::string messages;
+        for (const auto &[key, document] : documents_)
+        {
+            for (auto &token : SearchIndex::tokenize(document.message))
+                postings[std::move(token)].push_back(key);
+
+            uint64_t hours;
+            std::memcpy(&hours, &document.hours, sizeof(hours));
+            append_u64(documents, key);
+            append_u64(documents, hours);
+            append_u32(documents, static_cast<uint32_t>(messages.size()));
+            append_u32(documents, static_cast<uint32_t>(document.message.size()));
+            messages += document.message;
+        }
+
+        std::string directory;
+        std::string text;
+        std::string lists;
+        uint32_t count = 0;
+        for (const auto &[term, keys] : postings)
+        {
+            append_u32(directory, static_cast<uint32_t>(text.size()));
+            append_u32(directory, static_cast<uint32_t>(term.size()));
+            append_u32(directory, count);
+            append_u32(directory, static_cast<uint32_t>(keys.size()));
+            text += term;
+            for (uint64_t key : keys)
+                append_u64(lists, key);
+            count += static_cast<uint32_t>(keys.size());
+        }
+
+        std::string out(INDEX_MAGIC);
+        append_u32(out, static_cast<uint32_t>(clients_.size()));
+        for (const auto &client_id : clients_)
+        {
+            append_u32(out, static_cast<uint32_t>(client_id.size()));
+            out += client_id;
+        }
+        append_u32(out, static_cast<uint32_t>(postings.size()));
+        append_u32(out, static_cast<uint32_t>(text.size()));
+        append_u32(out, static_cast<uint32_t>(documents_.size()));
+        append_u32(out, static_cast<uint32_t>(messages.size()));
+        return out + directory + documents + text + messages + lists;
+    }
+
+private:
+    std::vector<std::string> clients_;
+    std::map<std::string, uint32_t> client_ids_;
+    std::map<uint64_t, Document> documents_;
+};
+
+// The committed index is mapped, so a lookup only touches the pages it
+// reads. Writes still pending in a WriteBatch are read from memory instead.
+class IndexFile
+{
+public:
+    IndexFile() = default;
+    IndexFile(const IndexFile &) = delete;
+    IndexFile &operator=(const IndexFile &) = delete;
+
+    ~IndexFile()
+    {
+        if (mapping_ != nullptr)
+            munmap(mapping_, size_);
+    }
+
+    bool open(const std::string &path)
+    {
+        if (DurableFile::read_pending(path, pending_))
+        {
+            data_ = pending_;
+            return true;
+        }
+        if (!DurableFile::exists(path))
+            return false;
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            size_ = static_cast<size_t>(st.st_size);
+            void *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                mapping_ = mapping;
+                data_ = std::string_view(static_cast<const char *>(mapping), size_);
+            }
+        }
+        ::close(fd);
+        return true;
+    }
+
+    std::string_view data() const { return data_; }
+
+private:
+    std::string pending_;
+    void *mapping_ = nullptr;
+    size_t size_ = 0;
+    std::string_view data_;
+};
+
+// Reads terms, documents and postings in place from the serialized index.
+class IndexView
+{
+public:
+    explicit IndexView(std::string_view data) : data_(data)
+    {
+        if (data_.substr(0, INDEX_MAGIC.size()) != INDEX_MAGIC)
+            throw std::runtime_error("Corrupt search index: " + SearchIndex::get_index_path());
+
+        size_t pos = INDEX_MAGIC.size();
+        uint32_t clients = read_u32(data_, pos);
+        pos += 4;
+        for (uint32_t i = 0; i < clients; i++)
+        {
+            uint32_t size = read_u32(data_, pos);
+            check_bounds(pos + 4 + size, data_.size());
+            clients_.emplace_back(data_.substr(pos + 4, size));
+            pos += 4 + size;
+        }
+
+        terms_ = read_u32(data_, pos);
+        uint32_t text_size = read_u32(data_, pos + 4);
+        documents_ = read_u32(data_, pos + 8);
+        uint32_t message_size = read_u32(data_, pos + 12);
+        directory_ = pos + 16;
+        document_table_ = directory_ + static_cast<size_t>(terms_) * DIRECTORY_ENTRY;
+        text_ = document_table_ + static_cast<size_t>(documents_) * DOCUMENT_ENTRY;
+        messages_ = text_ + text_size;
+        postings_ = messages_ + message_size;
+        check_bounds(postings_, data_.size());
+    }
+
+    const std::vector<std::string> &clients() const { return clients_; }
+    size_t documents() const { return documents_; }
+
+    uint64_t document_key(size_t index) const
+    {
+        return read_le(data_, document_table_ + index * DOCUMENT_ENTRY, 8);
+    }
+
+    Document document(size_t index) const
+    {
+        size_t entry = document_table_ + index * DOCUMENT_ENTRY;
+        uint64_t bits = read_le(data_, entry + 8, 8);
+        size_t offset = read_u32(data_, entry + 16);
+        size_t size = read_u32(data_, entry + 20);
+        check_bounds(messages_ + offset + size, postings_);
+
+        Document document;
+        std::memcpy(&document.hours, &bits, sizeof(bits));
+        document.message = std::string(data_.substr(messages_ + offset, size));
+        return document;
+    }
+
+    bool find_document(uint64_t key, Document &document) const
+    {
+        size_t low = 0, high = documents_;
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            if (document_key(mid) < key)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (low == documents_ || document_key(low) != key)
+            return false;
+        document = this->document(low);
+        return true;
+    }
+
+    struct Postings
+    {
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    Postings find_postings(std::string_view term) const
+    {
+        size_t low = 0, high = terms_;
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            if (this->term(mid) < term)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (low == terms_ || this->term(low) != term)
+            return {};
+
+        size_t entry = directory_ + low * DIRECTORY_ENTRY;
+        return {read_u32(data_, entry + 8), read_u32(data_, entry + 12)};
+    }
+
+    uint64_t posting(const Postings &postings, size_t index) const
+    {
+        return read_le(data_, postings_ + (postings.first + index) * 8, 8);
+    }
+
+    bool contains(const Postings &postings, uint64_t key) const
+    {
+        size_t low = 0, high = postings.count;
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            if (posting(postings, mid) < key)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return low < postings.count && posting(postings, low) == key;
+    }
+
+private:
+    std::string_view term(size_t index) const
+    {
+        size_t entry = directory_ + index * DIRECTORY_ENTRY;
+        size_t offset = read_u32(data_, entry);
+        size_t size = read_u32(data_, entry + 4);
+        check_bounds(text_ + offset + size, messages_);
+        return data_.substr(text_ + offset, size);
+    }
+
+    std::string_view data_;
+    std::vector<std::string> clients_;
+    uint32_t terms_ = 0;
+    uint32_t documents_ = 0;
+    size_t directory_ = 0;
+    size_t document_table_ = 0;
+    size_t text_ = 0;
+    size_t messages_ = 0;
+    size_t postings_ = 0;
+};
+
+struct JournalEntry
+{
+    std::string client_id;
+    Calendar::Date date;
+    double hours = 0.0;
+    std::string message;
+    // Set for a removal of every entry from date to until.
+    bool removal = false;
+    Calendar::Date until;
+};
+
+static void append_escaped(std::string &out, std::string_view text)
+{
+    for (char c : text)
+    {
+        if (c == '\\')
+            out += "\\\\";
+        else if (c == '\t')
+            out += "\\t";
+        else if (c == '\n')
+            out += "\\n";
+        else
+            out += c;
+    }
+}
+
+static std::string unescape(std::string_view text)
+{
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] != '\\' || i + 1 == text.size())
+        {
+            out += text[i];
+            continue;
+        }
+        char c = text[++i];
+        out += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+    }
+    return out;
+}
+
+// One line per recorded log: client \t yyyy-mm-dd \t hours \t escaped message,
+// or per removal: client \t yyyy-mm-dd \t - \t yyyy-mm-dd (the last day).
+// Later lines win over earlier ones and over the index for the same day.
+static std::vector<JournalEntry> parse_journal(const std::string &journal)
+{
+    std::vector<JournalEntry> entries;
+    size_t start = 0;
+    while (start < journal.size())
+    {
+        size_t end = journal.find('\n', start);
+        if (end == std::string::npos)
+            end = journal.size();
+        std::string_view line(journal.data() + start, end - start);
+        start = end + 1;
+
+        std::string_view fields[4];
+        size_t count = 0;
+        while (count < 3)
+        {
+            size_t tab = line.find('\t');
+            if (tab == std::string_view::npos)
+                break;
+            fields[count++] = line.substr(0, tab);
+            line.remove_prefix(tab + 1);
+        }
+        if (count < 3)
+            continue;
+        fields[3] = line;
+
+        JournalEntry entry;
+        entry.client_id = std::string(fields[0]);
+        entry.date = Calendar::parse_stored_date(fields[1]);
+        entry.removal = fields[2] == "-";
+        if (entry.removal)
+        {
+            entry.until = Calendar::parse_stored_date(fields[3]);
+        }
+        else
+        {
+            entry.hours = std::strtod(std::string(fields[2]).c_str(), nullptr);
+            entry.message = unescape(fields[3]);
+        }
+        if (entry.date.valid() && (!entry.removal || entry.until.valid()))
+            entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+static void write_index(const IndexBuilder &builder)
+{
+    ConfigManager::ensure_directories();
+    DurableFile::write(SearchIndex::get_index_path(), builder.serialize());
+    DurableFile::remove(SearchIndex::get_journal_path());
+}
+
+static void compact(const std::string &journal)
+{
+    IndexBuilder builder;
+    {
+        IndexFile file;
+        if (!file.open(SearchIndex::get_index_path()))
+            return;
+
+        IndexView view(file.data());
+        for (const auto &client_id : view.clients())
+            builder.client(client_id);
+        for (size_t i = 0; i < view.documents(); i++)
+        {
+            uint64_t key = view.document_key(i);
+            Document document = view.document(i);
+            builder.add(key_client(key), key_date(key), document.hours, document.message);
+        }
+    }
+
+    for (const auto &entry : parse_journal(journal))
+    {
+        if (entry.removal)
+            builder.remove(builder.client(entry.client_id), entry.date, entry.until);
+        else
+            builder.add(builder.client(entry.client_id), entry.date, entry.hours, entry.message);
+    }
+
+    write_index(builder);
+}
+
+static void append_journal(std::string_view line)
+{
+    std::string journal;
+    DurableFile::read(SearchIndex::get_journal_path(), journal);
+    journal += line;
+
+    if (static_cast<size_t>(std::count(journal.begin(), journal.end(), '\n')) >= SearchIndex::JOURNAL_LIMIT)
+    {
+        compact(journal);
+        return;
+    }
+    DurableFile::write(SearchIndex::get_journal_path(), journal);
+}
+
+static bool contains_all(const std::vector<std::string> &tokens, const std::vector<std::string> &terms)
+{
+    for (const auto &term : terms)
+    {
+        if (std::find(tokens.begin(), tokens.end(), term) == tokens.end())
+            return false;
+    }
+    return true;
+}
+
+std::string SearchIndex::get_index_path()
+{
+    return ConfigManager::get_config_dir() + "/search.idx";
+}
+
+std::string SearchIndex::get_journal_path()
+{
+    return ConfigManager::get_config_dir() + "/search.journal";
+}
+
+std::vector<std::string> SearchIndex::tokenize(std::string_view text)
+{
+    std::vector<std::string> tokens;
+    std::string token;
+    for (size_t i = 0; i <= text.size(); i++)
+    {
+        unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c >= 0x80)
+        {
+            token.push_back(static_cast<char>(c));
+        }
+        else if (c >= 'A' && c <= 'Z')
+        {
+            token.push_back(static_cast<char>(c - 'A' + 'a'));
+        }
+        else if (!token.empty())
+        {
+            if (std::find(tokens.begin(), tokens.end(), token) == tokens.end())
+                tokens.push_back(token);
+            token.clear();
+        }
+    }
+    return tokens;
+}
+
+void SearchIndex::record(const std::string &client_id, Calendar::Date date, double hours,
+                         std::string_view message)
+{
+    if (!DurableFile::exists(get_index_path()))
+        return;
+
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.17g", hours);
+    std::string line = client_id;
+    line += '\t';
+    line += Calendar::iso(date).view();
+    line += '\t';
+    line += number;
+    line += '\t';
+    append_escaped(line, message);
+    line += '\n';
+    append_journal(line);
+}
+
+void SearchIndex::forget(const std::string &client_id, Calendar::Date from, Calendar::Date to)
+{
+    if (!DurableFile::exists(get_index_path()))
+        return;
+
+    // month_start() and month_end() bounds are not real days, so they would not parse back.
+    from = Calendar::Date(from.year(), from.month(), std::max(from.day(), 1));
+    to = Calendar::Date(to.year(), to.month(), std::min(to.day(), Calendar::days_in_month(to.year(), to.month())));
+
+    std::string line = client_id;
+    line += '\t';
+    line += Calendar::iso(from).view();
+    line += "\t-\t";
+    line += Calendar::iso(to).view();
+    line += '\n';
+    append_journal(line);
+}
+
+void SearchIndex::rebuild()
+{
+    IndexBuilder builder;
+    for (const auto &[id, data] : BatchLoader::load_all())
+    {
+        uint32_t client = builder.client(id);
+        if (!data.archived_months.empty())
+        {
+            WorkLogTable archived = ArchiveManager::load(id);
+            for (const auto &row : archived.all())
+                builder.add(client, row.date, row.hours, row.message);
+        }
+        // Live entries win over archived ones, as in ClientManager::load.
+        for (const auto &row : data.logs.all())
+            builder.add(client, row.date, row.hours, row.message);
+    }
+    write_index(builder);
+}
+
+std::vector<SearchResult> SearchIndex::search(const std::string &query, const std::string &client_id,
+                                              Calendar::Date from, Calendar::Date to)
+{
+    std::vector<std::string> terms = tokenize(query);
+    if (terms.empty())
+        throw std::runtime_error("Search needs at least one word");
+
+    IndexFile file;
+    if (!file.open(get_index_path()))
+    {
+        rebuild();
+        if (!file.open(get_index_path()))
+            throw std::runtime_error("Could not open " + get_index_path());
+    }
+    IndexView index(file.data());
+
+    // Journal clients not in the index yet get indices past the indexed ones.
+    std::vector<std::string> clients = index.clients();
+    std::map<std::string, uint32_t> client_ids;
+    for (uint32_t i = 0; i < clients.size(); i++)
+        client_ids.emplace(clients[i], i);
+
+    std::string journal;
+    DurableFile::read(get_journal_path(), journal);
+    std::map<uint64_t, JournalEntry> recent;
+    std::vector<std::pair<uint64_t, uint64_t>> removed;
+    for (auto &entry : parse_journal(journal))
+    {
+        auto [it, inserted] = client_ids.emplace(entry.client_id, static_cast<uint32_t>(clients.size()));
+        if (inserted)
+            clients.push_back(entry.client_id);
+        uint64_t key = make_key(it->second, entry.date.value);
+        if (entry.removal)
+        {
+            uint64_t last = make_key(it->second, entry.until.value);
+            recent.erase(recent.lower_bound(key), recent.upper_bound(last));
+            removed.emplace_back(key, last);
+            continue;
+        }
+        recent[key] = std::move(entry);
+    }
+    auto was_removed = [&](uint64_t key) {
+        return std::any_of(removed.begin(), removed.end(), [&](const auto &range) {
+            return key >= range.first && key <= range.second;
+        });
+    };
+    std::map<uint64_t, std::vector<std::string>> recent_tokens;
+    for (const auto &[key, entry] : recent)
+        recent_tokens[key] = tokenize(entry.message);
+
+    // Candidates come from the rarest term; the others are probed by binary search.
+    std::vector<IndexView::Postings> postings;
+    for (const auto &term : terms)
+        postings.push_back(index.find_postings(term));
+    std::vector<size_t> order(terms.size());
+    for (size_t t = 0; t < order.size(); t++)
+        order[t] = t;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return postings[a].count < postings[b].count;
+    });
+
+    auto recent_has = [&](uint64_t key, const std::string &term) {
+        auto it = recent_tokens.find(key);
+        return it != recent_tokens.end() &&
+               std::find(it->second.begin(), it->second.end(), term) != it->second.end();
+    };
+
+    std::vector<uint64_t> matches;
+    const IndexView::Postings &rarest = postings[order[0]];
+    for (size_t i = 0; i < rarest.count; i++)
+        matches.push_back(index.posting(rarest, i));
+    for (const auto &[key, tokens] : recent_tokens)
+    {
+        if (recent_has(key, terms[order[0]]))
+            matches.push_back(key);
+    }
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+    for (size_t t = 1; t < order.size() && !matches.empty(); t++)
+    {
+        const std::string &term = terms[order[t]];
+        const IndexView::Postings &list = postings[order[t]];
+        matches.erase(std::remove_if(matches.begin(), matches.end(), [&](uint64_t key) {
+                          return !index.contains(list, key) && !recent_has(key, term);
+                      }),
+                      matches.end());
+    }
+
+    std::vector<SearchResult> results;
+    for (uint64_t key : matches)
+    {
+        const std::string &id = clients[key_client(key)];
+        Calendar::Date date = key_date(key);
+        if ((!client_id.empty() && id != client_id) || date < from || date > to)
+            continue;
+
+        // A journal entry replaces the indexed one, whose postings may not match it.
+        auto it = recent.find(key);
+        if (it != recent.end())
+        {
+            if (contains_all(recent_tokens[key], terms))
+                results.push_back({id, date, it->second.hours, it->second.message});
+            continue;
+        }
+
+        Document document;
+        if (!was_removed(key) && index.find_document(key, document))
+            results.push_back({id, date, document.hours, std::move(document.message)});
+    }
+
+    std::sort(results.begin(), results.end(), [](const SearchResult &a, const SearchResult &b) {
+        return a.client_id != b.client_id ? a.client_id < b.client_id : a.date < b.date;
+    });
+    return results;
+}
@@ -0,0 +1,412 @@
+#include "storage/sync.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/client.hpp"
+#include "storage/config.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/search_index.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+using MonthHashes = std::map<std::string, std::string>;
+
+// File name -> stamp.
+using FileStamps = std::map<std::string, std::string>;
+
+struct ClientSyncState
+{
+    FileStamps files;
+    MonthHashes months;
+    std::string details;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ClientSyncState, files, months, details)
+};
+
+// Sync directory -> client -> state.
+using SyncState = std::map<std::string, std::map<std::string, ClientSyncState>>;
+
+struct RemoteIndex
+{
+    ClientData client;
+    MonthHashes months;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(RemoteIndex, client, months)
+};
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+static void fnv(uint64_t &hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+static std::string hex(uint64_t hash)
+{
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+    return text;
+}
+
+// Size and modification time of each of the client's files: cheap to take
+// and different whenever that file has been saved since.
+static FileStamps local_stamps(const std::string &client_id)
+{
+    std::vector<fs::path> paths;
+    std::error_code ec;
+    if (ClientManager::is_sharded(client_id))
+    {
+        for (const auto &entry : fs::directory_iterator(ClientManager::get_client_dir(client_id), ec))
+            paths.push_back(entry.path());
+    }
+    else
+    {
+        paths.push_back(ClientManager::get_client_path(client_id));
+    }
+
+    FileStamps stamps;
+    for (const auto &path : paths)
+    {
+        uint64_t hash = FNV_OFFSET;
+        uint64_t size = fs::file_size(path, ec);
+        int64_t time = fs::last_write_time(path, ec).time_since_epoch().count();
+        fnv(hash, &size, sizeof(size));
+        fnv(hash, &time, sizeof(time));
+        stamps[path.filename().string()] = hex(hash);
+    }
+    return stamps;
+}
+
+static std::string shard_year(const std::string &name)
+{
+    fs::path path(name);
+    std::string year = path.stem().string();
+    bool shard = path.extension() == ".json" && year.size() == 4 &&
+                 std::all_of(year.begin(), year.end(), [](char c) { return c >= '0' && c <= '9'; });
+    return shard ? year : "";
+}
+
+// Years of a sharded client whose shard was written, added or removed since
+// the stamps in last were taken.
+static void changed_years(const FileStamps &now, const FileStamps &last, std::set<std::string> &years)
+{
+    for (const auto &[name, stamp] : now)
+    {
+        auto before = last.find(name);
+        if ((before == last.end() || before->second != stamp) && !shard_year(name).empty())
+            years.insert(shard_year(name));
+    }
+    for (const auto &[name, stamp] : last)
+    {
+        if (!now.count(name) && !shard_year(name).empty())
+            years.insert(shard_year(name));
+    }
+}
+
+static std::string remote_client_dir(const std::string &dir, const std::string &client_id)
+{
+    return dir + "/clients/" + client_id;
+}
+
+static std::string remote_month_path(const std::string &dir, const std::string &client_id,
+                                     const std::string &month_key)
+{
+    return remote_client_dir(dir, client_id) + "/" + month_key + ".json";
+}
+
+static bool read_remote_index(const std::string &dir, const std::string &client_id, RemoteIndex &index)
+{
+    std::string contents;
+    if (!DurableFile::read(remote_client_dir(dir, client_id) + "/index.json", contents))
+        return false;
+    index = nlohmann::json::parse(contents).get<RemoteIndex>();
+    return true;
+}
+
+static WorkLogTable read_remote_month(const std::string &dir, const std::string &client_id,
+                                      const std::string &month_key)
+{
+    std::string contents;
+    std::string path = remote_month_path(dir, client_id, month_key);
+    if (!DurableFile::read(path, contents))
+        throw std::runtime_error("Missing month in sync directory: " + path);
+    return nlohmann::json::parse(contents).get<WorkLogTable>();
+}
+
+static void write_remote_month(const std::string &dir, const std::string &client_id,
+                               const std::string &month_key, const WorkLogTable &logs)
+{
+    Calendar::Date month = Calendar::parse_month(month_key);
+    nlohmann::json j = logs.slice(month.month_start(), month.month_end());
+    DurableFile::write(remote_month_path(dir, client_id, month_key), j.dump());
+}
+
+static SyncState load_state()
+{
+    std::string contents;
+    if (!DurableFile::read(SyncManager::get_state_path(), contents))
+        return {};
+    return nlohmann::json::parse(contents).get<SyncState>();
+}
+
+// Replaces the month in local with its merge with remote (see SyncManager).
+static void merge_month(WorkLogTable &local, const WorkLogTable &remote, Calendar::Date month)
+{
+    for (const auto &row : remote.month(month))
+    {
+        bool keep_local = false;
+        for (const auto &mine : local.between(row.date, row.date))
+        {
+            keep_local = mine.hours > row.hours || (mine.hours == row.hours && mine.message >= row.message);
+        }
+        if (!keep_local)
+            local.set(row.date, row.hours, row.message);
+    }
+}
+
+std::string SyncManager::get_state_path()
+{
+    return ConfigManager::get_config_dir() + "/sync.json";
+}
+
+std::string SyncManager::month_hash(const WorkLogTable &logs, const std::string &month_key)
+{
+    uint64_t hash = FNV_OFFSET;
+    for (const auto &row : logs.month(month_key))
+    {
+        uint64_t hours;
+        std::memcpy(&hours, &row.hours, sizeof(hours));
+        uint32_t size = static_cast<uint32_t>(row.message.size());
+        fnv(hash, &row.date.value, sizeof(row.date.value));
+        fnv(hash, &hours, sizeof(hours));
+        fnv(hash, &size, sizeof(size));
+        fnv(hash, row.message.data(), row.message.size());
+    }
+    return hex(hash);
+}
+
+// Hash of what a client is billed by. Invoice numbers stay per machine.
+static std::string details_hash(const ClientData &client)
+{
+    uint64_t hash = FNV_OFFSET;
+    for (const std::string *field : {&client.name, &client.address_line1, &client.address_line2, &client.tag})
+    {
+        uint32_t size = static_cast<uint32_t>(field->size());
+        fnv(hash, &size, sizeof(size));
+        fnv(hash, field->data(), field->size());
+    }
+    uint64_t rate;
+    std::memcpy(&rate, &client.hourly_rate, sizeof(rate));
+    int32_t terms = client.payment_term_days;
+    fnv(hash, &rate, sizeof(rate));
+    fnv(hash, &terms, sizeof(terms));
+    return hex(hash);
+}
+
+static void copy_details(const ClientData &from, ClientData &to)
+{
+    to.name = from.name;
+    to.address_line1 = from.address_line1;
+    to.address_line2 = from.address_line2;
+    to.hourly_rate = from.hourly_rate;
+    to.payment_term_days = from.payment_term_days;
+    to.tag = from.tag;
+}
+
+SyncResult SyncManager::run(const std::string &dir)
+{
+    if (!fs::is_directory(dir))
+        throw std::runtime_error("Sync directory not found: " + dir);
+
+    std::string key = fs::absolute(dir).lexically_normal().string();
+    SyncState state = load_state();
+    std::map<std::string, ClientSyncState> &known = state[key];
+
+    std::set<std::string> ids;
+    for (const auto &id : BatchLoader::list_client_ids())
+        ids.insert(id);
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(dir + "/clients", ec))
+    {
+        if (entry.is_directory())
+            ids.insert(entry.path().filename().string());
+    }
+
+    SyncResult result;
+    std::vector<std::string> touched;
+    {
+        WriteBatch batch;
+        fs::create_directories(dir + "/clients");
+
+        for (const auto &id : ids)
+        {
+            RemoteIndex index;
+            bool has_remote = read_remote_index(dir, id, index);
+            bool has_local = ClientManager::client_exists(id);
+            if (!has_remote && !has_local)
+                continue;
+
+            ClientSyncState &base = known[id];
+            FileStamps stamps = has_local ? local_stamps(id) : FileStamps();
+            std::string theirs_details = has_remote ? details_hash(index.client) : "";
+            if (has_local && has_remote && base.files == stamps && base.months == index.months &&
+                base.details == theirs_details)
+                continue;
+
+            // After a sync every month matches on both sides, so a sharded
+            // client only needs the years whose shard or remote months have
+            // changed since; everything else is still what base says.
+            bool whole = !has_local || !has_remote || !ClientManager::is_sharded(id);
+            std::set<std::string> years;
+            if (!whole)
+            {
+                changed_years(stamps, base.files, years);
+                for (const auto &[month_key, hash] : index.months)
+                {
+                    auto last = base.months.find(month_key);
+                    if (last == base.months.end() || last->second != hash)
+                        years.insert(month_key.substr(0, 4));
+                }
+                for (const auto &[month_key, hash] : base.months)
+                {
+                    if (!index.months.count(month_key))
+                        years.insert(month_key.substr(0, 4));
+                }
+            }
+            auto in_scope = [&](const std::string &month_key) {
+                return whole || years.count(month_key.substr(0, 4)) > 0;
+            };
+
+            ClientData client = !has_local ? index.client : whole ? ClientManager::load(id)
+                                                                  : ClientManager::load_years(id, years);
+            if (!has_local)
+                client.archived_months.clear();
+
+            MonthHashes local;
+            for (Calendar::Date month : client.logs.months())
+            {
+                std::string month_key = Calendar::month_key(month).str();
+                local[month_key] = month_hash(client.logs, month_key);
+            }
+
+            std::set<std::string> months;
+            for (const auto &[month_key, hash] : local)
+                months.insert(month_key);
+            for (const auto &[month_key, hash] : index.months)
+            {
+                if (in_scope(month_key))
+                    months.insert(month_key);
+            }
+
+            fs::create_directories(remote_client_dir(dir, id));
+            bool local_changed = !has_local;
+            bool remote_changed = !has_remote;
+
+            // Details sync like one more month; when both sides changed them
+            // the greater hash wins, so every machine keeps the same ones.
+            std::string mine_details = details_hash(client);
+            if (has_local && has_remote && mine_details != theirs_details)
+            {
+                if (theirs_details == base.details ||
+                    (mine_details != base.details && mine_details > theirs_details))
+                {
+                    remote_changed = true;
+                }
+                else
+                {
+                    copy_details(index.client, client);
+                    local_changed = true;
+                }
+            }
+
+            for (const auto &month_key : months)
+            {
+                if (client.archived_months.count(month_key))
+                    continue;
+
+                std::string mine = local.count(month_key) ? local[month_key] : "";
+                std::string theirs = index.months.count(month_key) ? index.months[month_key] : "";
+                std::string last = base.months.count(month_key) ? base.months[month_key] : "";
+                if (mine == theirs)
+                    continue;
+
+                Calendar::Date month = Calendar::parse_month(month_key);
+                if (theirs == last && !mine.empty())
+                {
+                    write_remote_month(dir, id, month_key, client.logs);
+                    index.months[month_key] = mine;
+                    remote_changed = true;
+                    result.pushed++;
+                    continue;
+                }
+
+                WorkLogTable remote = read_remote_month(dir, id, month_key);
+                if (mine == last || mine.empty())
+                {
+                    client.logs.erase(month.month_start(), month.month_end());
+                    client.logs.merge(remote);
+                    result.pulled++;
+                }
+                else
+                {
+                    merge_month(client.logs, remote, month);
+                    std::string merged = month_hash(client.logs, month_key);
+                    write_remote_month(dir, id, month_key, client.logs);
+                    index.months[month_key] = merged;
+                    remote_changed = true;
+                    result.merged++;
+                }
+                local_changed = true;
+
+                // Dates the other side dropped must leave the index too.
+                SearchIndex::forget(id, month.month_start(), month.month_end());
+                for (const auto &row : client.logs.month(month))
+                    SearchIndex::record(id, row.date, row.hours, row.message);
+            }
+
+            if (local_changed)
+            {
+                if (whole)
+                    ClientManager::save(id, client);
+                else
+                    ClientManager::save_years(id, client, years);
+            }
+            base.details = details_hash(client);
+            if (remote_changed)
+            {
+                // The index carries the details; months live in their own files.
+                client.logs = WorkLogTable();
+                client.archived_months.clear();
+                index.client = std::move(client);
+                nlohmann::json j = index;
+                DurableFile::write(remote_client_dir(dir, id) + "/index.json", j.dump(2));
+            }
+
+            base.months = index.months;
+            touched.push_back(id);
+            result.clients++;
+        }
+
+        batch.commit();
+    }
+
+    // Stamps are taken from the files on disk, so only after the batch is written.
+    for (const auto &id : touched)
+        known[id].files = local_stamps(id);
+
+    nlohmann::json j = state;
+    DurableFile::write(get_state_path(), j.dump(2));
+    return result;
+}
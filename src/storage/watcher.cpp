@@ -0,0 +1,171 @@
+#include "storage/watcher.hpp"
+#include "storage/config.hpp"
+#include <filesystem>
+#include <stdexcept>
+
+#if defined(__linux__) && __has_include(<sys/inotify.h>)
+#define WLOG_HAVE_INOTIFY 1
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static constexpr int SETTLE_MS = 50;
+
+static bool ends_with(const std::string &text, const std::string &suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool ClientWatcher::available()
+{
+#ifdef WLOG_HAVE_INOTIFY
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef WLOG_HAVE_INOTIFY
+
+static constexpr uint32_t FILE_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+
+ClientWatcher::ClientWatcher()
+{
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0)
+        throw std::runtime_error("Could not initialize inotify");
+
+    std::string dir = ConfigManager::get_clients_dir();
+    root_ = inotify_add_watch(fd_, dir.c_str(), FILE_EVENTS | IN_CREATE | IN_ONLYDIR);
+    if (root_ < 0)
+    {
+        close(fd_);
+        throw std::runtime_error("Could not watch " + dir);
+    }
+
+    watch_client_dirs();
+}
+
+ClientWatcher::~ClientWatcher()
+{
+    close(fd_);
+}
+
+// Adding a watch twice is harmless: inotify returns the existing one.
+void ClientWatcher::watch_client_dirs()
+{
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(ConfigManager::get_clients_dir(), ec))
+    {
+        if (entry.is_directory())
+            watch_client_dir(entry.path().filename().string());
+    }
+}
+
+void ClientWatcher::watch_client_dir(const std::string &client_id)
+{
+    std::string dir = ConfigManager::get_clients_dir() + "/" + client_id;
+    int wd = inotify_add_watch(fd_, dir.c_str(), FILE_EVENTS | IN_ONLYDIR);
+    if (wd >= 0)
+        client_dirs_[wd] = client_id;
+}
+
+void ClientWatcher::read_events(std::set<std::string> &changed)
+{
+    alignas(inotify_event) char buffer[16 * 1024];
+    while (true)
+    {
+        ssize_t size = read(fd_, buffer, sizeof(buffer));
+        if (size < 0 && errno == EINTR)
+            continue;
+        if (size <= 0)
+            return;
+
+        for (char *p = buffer; p < buffer + size;)
+        {
+            const inotify_event *event = reinterpret_cast<const inotify_event *>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // Sharded clients created in the gap were never watched.
+                overflowed_ = true;
+                watch_client_dirs();
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                client_dirs_.erase(event->wd);
+                continue;
+            }
+
+            std::string name = event->len > 0 ? event->name : "";
+            if (ends_with(name, ".tmp"))
+                continue;
+
+            if (event->wd == root_)
+            {
+                if (event->mask & IN_ISDIR)
+                {
+                    // A client switching to the sharded layout.
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                        watch_client_dir(name);
+                    changed.insert(name);
+                }
+                else if (ends_with(name, ".json"))
+                {
+                    changed.insert(name.substr(0, name.size() - 5));
+                }
+                continue;
+            }
+
+            auto dir = client_dirs_.find(event->wd);
+            if (dir != client_dirs_.end() && ends_with(name, ".json"))
+                changed.insert(dir->second);
+        }
+    }
+}
+
+std::set<std::string> ClientWatcher::wait(int timeout_ms)
+{
+    std::set<std::string> changed;
+    overflowed_ = false;
+    pollfd pfd = {fd_, POLLIN, 0};
+
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0)
+        return changed;
+
+    // A save touches several files (shards, then meta); wait for the burst to end.
+    do
+    {
+        read_events(changed);
+    } while (poll(&pfd, 1, SETTLE_MS) > 0);
+
+    return changed;
+}
+
+#else
+
+ClientWatcher::ClientWatcher()
+{
+    throw std::runtime_error("Watching requires inotify, which is not available on this platform");
+}
+
+ClientWatcher::~ClientWatcher() = default;
+
+void ClientWatcher::watch_client_dirs() {}
+void ClientWatcher::watch_client_dir(const std::string &) {}
+void ClientWatcher::read_events(std::set<std::string> &) {}
+
+std::set<std::string> ClientWatcher::wait(int)
+{
+    return {};
+}
+
+#endif
@@ -0,0 +1,266 @@
+#include "storage/work_log_table.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+static MessageEncoding encoding = MessageEncoding::Inline;
+
+void WorkLogTable::set_encoding(MessageEncoding value)
+{
+    encoding = value;
+}
+
+MessageEncoding WorkLogTable::get_encoding()
+{
+    return encoding;
+}
+
+double WorkLogTable::Range::total_hours() const
+{
+    const std::pmr::vector<double> &hours = table_->hours();
+    double total = 0.0;
+    for (size_t i = begin_; i < end_; i++)
+    {
+        total += hours[i];
+    }
+    return total;
+}
+
+WorkLogTable::EntryRef::EntryRef(WorkLogTable &table, size_t index)
+    : hours(table.hours_[index]), message(table.row(index).message), table_(table), index_(index)
+{
+}
+
+WorkLogTable::EntryRef &WorkLogTable::EntryRef::operator=(const WorkLog &log)
+{
+    hours = log.hours;
+    table_.set_message(index_, log.message);
+    message = table_.row(index_).message;
+    return *this;
+}
+
+WorkLogTable::EntryRef WorkLogTable::MonthRef::operator[](const std::string &date)
+{
+    Calendar::Date packed = Calendar::parse_stored_date(date);
+    if (!month_.valid() || packed.month_start() != month_)
+    {
+        throw std::runtime_error("Date " + date + " is outside the indexed month");
+    }
+
+    size_t index = table_.lower_bound(packed);
+    if (index == table_.size() || table_.dates_[index] != packed.value)
+    {
+        index = table_.insert_at(index, packed);
+        table_.set_message(index, "");
+    }
+    return {table_, index};
+}
+
+size_t WorkLogTable::MonthRef::count(const std::string &date) const
+{
+    Calendar::Date packed = Calendar::parse_stored_date(date);
+    return packed.valid() && packed.month_start() == month_ && table_.contains(packed) ? 1 : 0;
+}
+
+WorkLogTable::Range WorkLogTable::between(Calendar::Date from, Calendar::Date to) const
+{
+    return {this, lower_bound(from), lower_bound(Calendar::Date(to.value + 1))};
+}
+
+std::vector<Calendar::Date> WorkLogTable::months() const
+{
+    std::vector<Calendar::Date> result;
+    for (uint32_t date : dates_)
+    {
+        Calendar::Date month = Calendar::Date(date).month_start();
+        if (result.empty() || result.back() != month)
+        {
+            result.push_back(month);
+        }
+    }
+    return result;
+}
+
+WorkLogRow WorkLogTable::row(size_t index) const
+{
+    return {Calendar::Date(dates_[index]), hours_[index], pool_->get(message_ids_[index])};
+}
+
+void WorkLogTable::share_pool(const std::shared_ptr<MessagePool> &pool)
+{
+    if (pool_ == pool)
+    {
+        return;
+    }
+    for (uint32_t &id : message_ids_)
+    {
+        id = pool->intern(pool_->get(id));
+    }
+    pool_ = pool;
+}
+
+void WorkLogTable::set(Calendar::Date date, double hours, std::string_view message)
+{
+    size_t index = lower_bound(date);
+    if (index == size() || dates_[index] != date.value)
+    {
+        index = insert_at(index, date);
+    }
+    hours_[index] = hours;
+    set_message(index, message);
+}
+
+void WorkLogTable::set(const std::string &date, double hours, std::string_view message)
+{
+    Calendar::Date packed = Calendar::parse_stored_date(date);
+    if (!packed.valid())
+    {
+        throw std::runtime_error("Invalid work log date: " + date);
+    }
+    set(packed, hours, message);
+}
+
+bool WorkLogTable::contains(Calendar::Date date) const
+{
+    size_t index = lower_bound(date);
+    return index < size() && dates_[index] == date.value;
+}
+
+void WorkLogTable::erase(Calendar::Date from, Calendar::Date to)
+{
+    size_t begin = lower_bound(from);
+    size_t end = lower_bound(Calendar::Date(to.value + 1));
+    dates_.erase(dates_.begin() + begin, dates_.begin() + end);
+    hours_.erase(hours_.begin() + begin, hours_.begin() + end);
+    message_ids_.erase(message_ids_.begin() + begin, message_ids_.begin() + end);
+}
+
+void WorkLogTable::merge(const WorkLogTable &other, bool overwrite)
+{
+    if (empty())
+    {
+        *this = other;
+        return;
+    }
+
+    for (const auto &row : other.all())
+    {
+        if (overwrite || !contains(row.date))
+        {
+            set(row.date, row.hours, row.message);
+        }
+    }
+}
+
+WorkLogTable WorkLogTable::slice(Calendar::Date from, Calendar::Date to) const
+{
+    WorkLogTable result;
+    for (const auto &row : between(from, to))
+    {
+        result.set(row.date, row.hours, row.message);
+    }
+    return result;
+}
+
+size_t WorkLogTable::lower_bound(Calendar::Date date) const
+{
+    return static_cast<size_t>(std::lower_bound(dates_.begin(), dates_.end(), date.value) - dates_.begin());
+}
+
+size_t WorkLogTable::insert_at(size_t index, Calendar::Date date)
+{
+    dates_.insert(dates_.begin() + index, date.value);
+    hours_.insert(hours_.begin() + index, 0.0);
+    message_ids_.insert(message_ids_.begin() + index, 0);
+    return index;
+}
+
+void WorkLogTable::set_message(size_t index, std::string_view message)
+{
+    if (!pool_)
+    {
+        pool_ = std::allocate_shared<MessagePool>(std::pmr::polymorphic_allocator<MessagePool>());
+    }
+    message_ids_[index] = pool_->intern(message);
+}
+
+// Dictionary encoding stores each distinct message once under "messages"
+// and refers to it by index; month keys never collide with that key.
+void to_json(nlohmann::json &j, const WorkLogTable &table)
+{
+    j = nlohmann::json::object();
+    nlohmann::json *month = nullptr;
+    Calendar::Date current_month;
+
+    bool dictionary = WorkLogTable::get_encoding() == MessageEncoding::Dictionary;
+    std::unordered_map<std::string_view, size_t> indices;
+    nlohmann::json messages = nlohmann::json::array();
+
+    for (const auto &row : table.all())
+    {
+        if (!month || row.date.month_start() != current_month)
+        {
+            current_month = row.date.month_start();
+            month = &j[Calendar::month_key(row.date).str()];
+        }
+
+        nlohmann::json message;
+        if (dictionary)
+        {
+            auto [it, inserted] = indices.emplace(row.message, messages.size());
+            if (inserted)
+            {
+                messages.push_back(std::string(row.message));
+            }
+            message = it->second;
+        }
+        else
+        {
+            message = std::string(row.message);
+        }
+
+        (*month)[Calendar::iso(row.date).str()] = {{"hours", row.hours}, {"message", message}};
+    }
+
+    if (dictionary && !messages.empty())
+    {
+        j["messages"] = std::move(messages);
+    }
+}
+
+void from_json(const nlohmann::json &j, WorkLogTable &table)
+{
+    table = WorkLogTable{};
+    const nlohmann::json *messages = nullptr;
+    auto found = j.find("messages");
+    if (found != j.end())
+    {
+        messages = &*found;
+    }
+
+    for (const auto &[month_key, days] : j.items())
+    {
+        if (month_key == "messages")
+        {
+            continue;
+        }
+
+        for (const auto &[date, entry] : days.items())
+        {
+            double hours = entry.value("hours", 0.0);
+            auto message = entry.find("message");
+            if (message == entry.end())
+            {
+                table.set(date, hours, "");
+            }
+            else if (message->is_number_unsigned() && messages)
+            {
+                table.set(date, hours, messages->at(message->get<size_t>()).get_ref<const std::string &>());
+            }
+            else
+            {
+                table.set(date, hours, message->get_ref<const std::string &>());
+            }
+        }
+    }
+}
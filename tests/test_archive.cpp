@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <sstream>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/archive.hpp"
+#include "command/log.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class ArchiveTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_archive");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        ClientData client;
+        client.name = "Archive Client";
+        client.tag = "ARC";
+        client.hourly_rate = 70.0;
+        client.logs["2024-01"]["2024-01-10"] = {8.0, "Old work"};
+        client.logs["2024-02"]["2024-02-11"] = {6.0, "Older work"};
+        client.logs["2026-01"]["2026-01-05"] = {4.0, "Recent work"};
+        ClientManager::save("archiveclient", client);
+    }
+
+    void TearDown() override
+    {
+        ClientManager::set_layout(ClientLayout::SingleFile);
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(ArchiveTest, MovesOldMonthsOutOfLiveData)
+{
+    EXPECT_EQ(ArchiveManager::archive_client("archiveclient", "2025-01"), 2);
+    EXPECT_TRUE(fs::exists(ArchiveManager::get_archive_path("archiveclient")));
+
+    ClientData live = ClientManager::load("archiveclient");
+    EXPECT_EQ(live.logs.count("2024-01"), 0u);
+    EXPECT_EQ(live.logs.count("2024-02"), 0u);
+    EXPECT_EQ(live.logs.count("2026-01"), 1u);
+    EXPECT_EQ(live.archived_months, (std::set<std::string>{"2024-01", "2024-02"}));
+}
+
+TEST_F(ArchiveTest, MonthLoadReadsArchive)
+{
+    ArchiveManager::archive_client("archiveclient", "2025-01");
+
+    ClientData month = ClientManager::load("archiveclient", "2024-02");
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(month, "2024-02"), 6.0);
+    EXPECT_EQ(month.logs["2024-02"]["2024-02-11"].message, "Older work");
+}
+
+TEST_F(ArchiveTest, RangeLoadMergesArchivedMonths)
+{
+    ArchiveManager::archive_client("archiveclient", "2025-01");
+
+    ClientData loaded = ClientManager::load("archiveclient", Calendar::Date(2024, 2, 1), Calendar::Date(2026, 1, 31));
+    WorkLogTable::Range rows = loaded.logs.between(Calendar::Date(2024, 2, 1), Calendar::Date(2026, 1, 31));
+    EXPECT_EQ(rows.size(), 2u);
+    EXPECT_DOUBLE_EQ(rows.total_hours(), 10.0);
+}
+
+TEST_F(ArchiveTest, ShowAllReadsArchivedMonths)
+{
+    ArchiveManager::archive_client("archiveclient", "2025-01");
+
+    auto show_all = [](WlogOptions opts) {
+        std::ostringstream out;
+        std::streambuf *saved = std::cout.rdbuf(out.rdbuf());
+        opts.all = opts.show = true;
+        run_show_all(opts);
+        std::cout.rdbuf(saved);
+        return out.str();
+    };
+
+    WlogOptions month;
+    month.month = "2024-02";
+    EXPECT_NE(show_all(month).find("Total: 6.0 hours"), std::string::npos);
+
+    WlogOptions range;
+    range.from = "2024-01-01";
+    range.to = "2026-01-31";
+    EXPECT_NE(show_all(range).find("Total: 18.0 hours"), std::string::npos);
+}
+
+TEST_F(ArchiveTest, NothingToArchive)
+{
+    EXPECT_EQ(ArchiveManager::archive_client("archiveclient", "2023-01"), 0);
+    EXPECT_FALSE(fs::exists(ArchiveManager::get_archive_path("archiveclient")));
+}
+
+TEST_F(ArchiveTest, LateEntriesMergeIntoArchive)
+{
+    ArchiveManager::archive_client("archiveclient", "2025-01");
+    ClientManager::add_work_log("archiveclient", "2024-01-12", 2.0, "Backdated");
+
+    ClientData month = ClientManager::load("archiveclient", "2024-01");
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(month, "2024-01"), 10.0);
+
+    EXPECT_EQ(ArchiveManager::archive_client("archiveclient", "2025-01"), 1);
+    WorkLogTable archived = ArchiveManager::load("archiveclient");
+    EXPECT_EQ(archived["2024-01"].size(), 2u);
+}
+
+TEST_F(ArchiveTest, ArchivingDropsEmptiedShards)
+{
+    ClientManager::set_layout(ClientLayout::Sharded);
+    ClientManager::add_work_log("archiveclient", "2026-01-06", 1.0, "Migrate");
+    ASSERT_TRUE(fs::exists(ClientManager::get_shard_path("archiveclient", "2024")));
+
+    ArchiveManager::archive_client("archiveclient", "2025-01");
+
+    EXPECT_FALSE(fs::exists(ClientManager::get_shard_path("archiveclient", "2024")));
+    ClientData month = ClientManager::load("archiveclient", "2024-01");
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(month, "2024-01"), 8.0);
+}
+
+TEST_F(ArchiveTest, CutoffMonthFormat)
+{
+    std::string cutoff = ArchiveManager::get_cutoff_month(12);
+    ASSERT_EQ(cutoff.size(), 7u);
+    EXPECT_EQ(cutoff[4], '-');
+    EXPECT_LT(cutoff, ArchiveManager::get_cutoff_month(0));
+}
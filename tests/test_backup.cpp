@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "storage/backup.hpp"
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/durable_file.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class BackupTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+    std::string dest;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_backup");
+        dest = test_dir + "/backups";
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        ClientData acme;
+        acme.name = "Acme";
+        for (int month = 1; month <= 12; month++)
+        {
+            for (int day = 1; day <= 28; day++)
+            {
+                Calendar::Date date(2025, month, day);
+                acme.logs.set(date, 1.0 + day % 8, "Work item " + std::to_string(month * 100 + day));
+            }
+        }
+        ClientManager::save("acme", acme);
+
+        ClientData beta;
+        beta.name = "Beta";
+        beta.logs["2026-01"]["2026-01-05"] = {2.0, "Call"};
+        ClientManager::save("beta", beta);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+
+    static std::string read(const std::string &path)
+    {
+        std::string contents;
+        DurableFile::read(path, contents);
+        return contents;
+    }
+};
+
+TEST_F(BackupTest, ChunkBoundariesFollowContent)
+{
+    std::mt19937 random(42);
+    std::string data(200 * 1024, '\0');
+    for (char &c : data)
+        c = static_cast<char>(random());
+
+    std::vector<size_t> ends = BackupManager::chunk(data);
+    ASSERT_GT(ends.size(), 5u);
+    EXPECT_EQ(ends.back(), data.size());
+    for (size_t i = 0; i + 1 < ends.size(); i++)
+    {
+        size_t size = ends[i] - (i == 0 ? 0 : ends[i - 1]);
+        EXPECT_GE(size, BackupManager::MIN_CHUNK);
+        EXPECT_LE(size, BackupManager::MAX_CHUNK);
+    }
+
+    // Inserting bytes near the start only moves the boundaries around it.
+    std::string edited = data;
+    edited.insert(100, "inserted");
+    std::vector<size_t> shifted = BackupManager::chunk(edited);
+    size_t shared = 0;
+    for (size_t end : ends)
+        shared += std::count(shifted.begin(), shifted.end(), end + 8);
+    EXPECT_GE(shared, ends.size() - 2);
+}
+
+TEST_F(BackupTest, SecondBackupOnlyStoresChanges)
+{
+    BackupResult first = BackupManager::backup(dest);
+    EXPECT_GE(first.files, 3u);
+    EXPECT_EQ(first.files_read, first.files);
+    EXPECT_GT(first.chunks_written, 2u);
+
+    BackupResult unchanged = BackupManager::backup(dest);
+    EXPECT_EQ(unchanged.files, first.files);
+    EXPECT_EQ(unchanged.files_read, 0u);
+    EXPECT_EQ(unchanged.chunks_written, 0u);
+
+    ClientManager::add_work_log("acme", "2025-12-29", 3.0, "Year end");
+    BackupResult changed = BackupManager::backup(dest);
+    EXPECT_GE(changed.files_read, 1u);
+    EXPECT_LT(changed.chunks_written, first.chunks_written);
+    EXPECT_EQ(BackupManager::list(dest).size(), 3u);
+}
+
+TEST_F(BackupTest, RestoresAnySnapshot)
+{
+    std::string acme_path = ClientManager::get_client_path("acme");
+    std::string original = read(acme_path);
+    std::string first = BackupManager::backup(dest).snapshot;
+
+    ClientManager::add_work_log("acme", "2026-01-02", 5.0, "New year");
+    ClientData gamma;
+    gamma.name = "Gamma";
+    ClientManager::save("gamma", gamma);
+    std::string edited = read(acme_path);
+    BackupManager::backup(dest);
+
+    EXPECT_EQ(BackupManager::restore(dest, first), first);
+    EXPECT_EQ(read(acme_path), original);
+    EXPECT_FALSE(ClientManager::client_exists("gamma"));
+
+    BackupManager::restore(dest);
+    EXPECT_EQ(read(acme_path), edited);
+    EXPECT_TRUE(ClientManager::client_exists("gamma"));
+
+    EXPECT_THROW(BackupManager::restore(dest, "missing"), std::runtime_error);
+}
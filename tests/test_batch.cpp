@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/durable_file.hpp"
+#include "command/batch.hpp"
+#include "command/options.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class BatchTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_batch");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        ClientData client;
+        client.name = "Batch Client";
+        client.tag = "BAT";
+        client.hourly_rate = 80.0;
+        ClientManager::save("batchclient", client);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+
+    std::vector<nlohmann::json> run(const std::string &input, int &status, unsigned checkpoint = 0)
+    {
+        std::istringstream in(input);
+        std::ostringstream out;
+        status = run_batch(in, out, parse_batch_line, checkpoint);
+
+        std::vector<nlohmann::json> results;
+        std::istringstream lines(out.str());
+        std::string line;
+        while (std::getline(lines, line))
+            results.push_back(nlohmann::json::parse(line));
+        return results;
+    }
+};
+
+TEST_F(BatchTest, LogsAndShowsInOneSession)
+{
+    int status = 0;
+    auto results = run("batchclient 8 \"Code review\" 2026-01-05\n"
+                       "batchclient 4 Standup 2026-01-06\n"
+                       "\n"
+                       "# comment\n"
+                       "batchclient --show --month 2026-01\n",
+                       status);
+
+    EXPECT_EQ(status, 0);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0]["ok"]);
+    EXPECT_EQ(results[0]["message"], "Code review");
+    EXPECT_EQ(results[2]["line"], 5);
+    EXPECT_EQ(results[2]["entries"].size(), 2u);
+    EXPECT_DOUBLE_EQ(results[2]["total_hours"].get<double>(), 12.0);
+
+    ClientData loaded = ClientManager::load("batchclient");
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(loaded, "2026-01"), 12.0);
+}
+
+TEST_F(BatchTest, ReportsErrorsPerLine)
+{
+    int status = 0;
+    auto results = run("missing 8 Work 2026-01-05\n"
+                       "batchclient 8 Work 2026-02-30\n"
+                       "batchclient --bogus\n"
+                       "batchclient 2 Work 2026-01-07\n",
+                       status);
+
+    EXPECT_EQ(status, 1);
+    ASSERT_EQ(results.size(), 4u);
+    EXPECT_FALSE(results[0]["ok"]);
+    EXPECT_FALSE(results[1]["ok"]);
+    EXPECT_FALSE(results[2]["ok"]);
+    EXPECT_TRUE(results[3]["ok"]);
+}
+
+TEST_F(BatchTest, ShowAllSeesUnflushedLogs)
+{
+    int status = 0;
+    auto results = run("batchclient 3 Work 2026-03-02\n"
+                       "--all --show --month 2026-03\n",
+                       status);
+
+    ASSERT_EQ(results.size(), 2u);
+    ASSERT_EQ(results[1]["clients"].size(), 1u);
+    EXPECT_DOUBLE_EQ(results[1]["total_hours"].get<double>(), 3.0);
+}
+
+TEST_F(BatchTest, CheckpointsFlushToDisk)
+{
+    std::string path = ClientManager::get_client_path("batchclient");
+    std::vector<bool> on_disk;
+    BatchParser parser = [&](const std::string &line, WlogOptions &opts, std::string &error) {
+        std::ifstream file(path);
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        on_disk.push_back(contents.find("2026-01-05") != std::string::npos);
+        return parse_batch_line(line, opts, error);
+    };
+
+    std::istringstream in("batchclient 1 Work 2026-01-05\n"
+                          "batchclient 1 Work 2026-01-06\n"
+                          "batchclient 1 Work 2026-01-07\n");
+    std::ostringstream out;
+    EXPECT_EQ(run_batch(in, out, parser, 2), 0);
+
+    std::vector<bool> expected = {false, false, true};
+    EXPECT_EQ(on_disk, expected);
+    EXPECT_EQ(ClientManager::load("batchclient").logs.size(), 3u);
+}
+
+TEST_F(BatchTest, ShowsDateRanges)
+{
+    int status = 0;
+    auto results = run("batchclient 8 Work 2025-12-30\n"
+                       "batchclient 4 Work 2026-01-02\n"
+                       "batchclient 2 Work 2026-02-01\n"
+                       "batchclient --show --from 2025-12-01 --to 2026-01-31\n"
+                       "batchclient --show --from 2026-01-31 --to 2026-01-01\n",
+                       status);
+
+    ASSERT_EQ(results.size(), 5u);
+    EXPECT_EQ(results[3]["from"], "2025-12-01");
+    EXPECT_EQ(results[3]["entries"].size(), 2u);
+    EXPECT_DOUBLE_EQ(results[3]["total_hours"].get<double>(), 12.0);
+    EXPECT_FALSE(results[4]["ok"]);
+}
+
+TEST(BatchParseTest, UsesCommandLineGrammar)
+{
+    std::string error;
+
+    WlogOptions log;
+    ASSERT_TRUE(parse_batch_line("acme 7.5 \"Design review, part 2\" 2026-01-05", log, error)) << error;
+    EXPECT_EQ(log.client, "acme");
+    EXPECT_DOUBLE_EQ(log.hours, 7.5);
+    EXPECT_EQ(log.message, "Design review, part 2");
+    EXPECT_EQ(log.day, "2026-01-05");
+
+    WlogOptions flags;
+    ASSERT_TRUE(parse_batch_line("acme -s -t", flags, error)) << error;
+    EXPECT_TRUE(flags.show);
+    EXPECT_TRUE(flags.today_only);
+
+    WlogOptions month;
+    ASSERT_TRUE(parse_batch_line("acme -r -m 3", month, error)) << error;
+    EXPECT_TRUE(month.report);
+    EXPECT_EQ(month.month, Calendar::month_key(Calendar::Date(Calendar::today().year(), 3, 1)).str());
+
+    WlogOptions all;
+    ASSERT_TRUE(parse_batch_line("-a -i --month 2026-01", all, error)) << error;
+    EXPECT_TRUE(all.all);
+    EXPECT_TRUE(all.invoice);
+    EXPECT_EQ(all.month, "2026-01");
+
+    WlogOptions unknown;
+    EXPECT_FALSE(parse_batch_line("acme --bogus", unknown, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(ShowRangeTest, ResolvesWeekAndLastDays)
+{
+    Calendar::Date today(2026, 1, 8);
+    Calendar::Date from, to;
+
+    WlogOptions opts;
+    EXPECT_FALSE(resolve_show_range(opts, today, from, to));
+
+    opts.week = true;
+    ASSERT_TRUE(resolve_show_range(opts, today, from, to));
+    EXPECT_EQ(from, Calendar::Date(2026, 1, 5));
+    EXPECT_EQ(to, Calendar::Date(2026, 1, 11));
+
+    opts.week = false;
+    opts.last = 10;
+    ASSERT_TRUE(resolve_show_range(opts, today, from, to));
+    EXPECT_EQ(from, Calendar::Date(2025, 12, 30));
+    EXPECT_EQ(to, today);
+
+    opts.last = 0;
+    opts.to = "2026-01-01";
+    EXPECT_THROW(resolve_show_range(opts, today, from, to), std::runtime_error);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sys/resource.h>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/batch_loader.hpp"
+#include "storage/durable_file.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class BatchLoaderTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_batch_loader");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        for (int i = 0; i < 150; i++)
+        {
+            ClientData client;
+            client.name = "Client " + std::to_string(i);
+            client.tag = "C" + std::to_string(i);
+            client.hourly_rate = 50.0 + i;
+            client.logs["2026-01"]["2026-01-05"] = {static_cast<double>(i % 8 + 1), "Work"};
+            ClientManager::save("client" + std::to_string(i), client);
+        }
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(BatchLoaderTest, ListsClientIds)
+{
+    std::ofstream(ConfigManager::get_clients_dir() + "/notes.txt") << "ignored";
+
+    std::vector<std::string> ids = BatchLoader::list_client_ids();
+    EXPECT_EQ(ids.size(), 150u);
+    EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+}
+
+TEST_F(BatchLoaderTest, LoadAllMatchesSerialLoad)
+{
+    std::map<std::string, ClientData> clients = BatchLoader::load_all(4);
+    ASSERT_EQ(clients.size(), 150u);
+
+    for (const auto &[id, client] : clients)
+    {
+        ClientData serial = ClientManager::load(id);
+        EXPECT_EQ(client.name, serial.name);
+        EXPECT_EQ(client.hourly_rate, serial.hourly_rate);
+        EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(client, "2026-01"),
+                         ClientManager::get_month_total_hours(serial, "2026-01"));
+    }
+}
+
+TEST_F(BatchLoaderTest, SkipsMissingClients)
+{
+    std::map<std::string, ClientData> clients = BatchLoader::load({"client1", "missing", "client2"});
+    EXPECT_EQ(clients.size(), 2u);
+    EXPECT_EQ(clients.count("missing"), 0u);
+}
+
+TEST_F(BatchLoaderTest, SeesPendingBatchWrites)
+{
+    WriteBatch batch;
+    ClientManager::add_work_log("client1", "2026-01-06", 4.0, "Pending");
+
+    std::map<std::string, ClientData> clients = BatchLoader::load({"client1"});
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(clients["client1"], "2026-01"), 6.0);
+}
+
+TEST_F(BatchLoaderTest, ThrowsOnCorruptFile)
+{
+    std::ofstream(ConfigManager::get_clients_dir() + "/broken.json") << "{ not json";
+    EXPECT_THROW(BatchLoader::load_all(), std::exception);
+}
+
+TEST_F(BatchLoaderTest, ClientsShareMessagePool)
+{
+    std::map<std::string, ClientData> clients = BatchLoader::load_all(4);
+    ASSERT_FALSE(clients.empty());
+
+    const auto &pool = clients.begin()->second.logs.pool();
+    ASSERT_TRUE(pool);
+    EXPECT_EQ(pool->size(), 1u);
+    for (const auto &[id, client] : clients)
+    {
+        EXPECT_EQ(client.logs.pool(), pool);
+    }
+}
+
+TEST_F(BatchLoaderTest, LoadsMoreClientsThanOpenFileLimit)
+{
+    size_t open_files = std::distance(fs::directory_iterator("/proc/self/fd"), fs::directory_iterator());
+    rlimit original;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &original), 0);
+
+    // Room for a few descriptors, far fewer than the 150 clients.
+    rlimit lowered = original;
+    lowered.rlim_cur = open_files + 24;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &lowered), 0);
+    std::map<std::string, ClientData> clients;
+    EXPECT_NO_THROW(clients = BatchLoader::load_all(2));
+    setrlimit(RLIMIT_NOFILE, &original);
+
+    EXPECT_EQ(clients.size(), 150u);
+}
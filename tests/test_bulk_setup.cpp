@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "flow/bulk_setup.hpp"
+#include "flow/validation.hpp"
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/registry.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class BulkSetupTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+    std::string logo;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_bulk_setup");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+
+        logo = test_dir + "/logo.jpg";
+        std::ofstream(logo) << "jpeg";
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+
+    nlohmann::json company() const
+    {
+        return {{"name", "Bulk Co"}, {"address_line1", "1 Main St"}, {"address_line2", "Town"},
+                {"kvk", "123"}, {"btw", "NL123"}, {"bank_account", "NL00BANK0123"},
+                {"tag", "BC"}, {"logo_path", logo}};
+    }
+
+    static nlohmann::json client(const std::string &name, double rate)
+    {
+        return {{"name", name}, {"address_line1", "2 Side St"}, {"address_line2", "City"},
+                {"hourly_rate", rate}, {"tag", name.substr(0, 3)}};
+    }
+};
+
+TEST_F(BulkSetupTest, CreatesAndUpdatesClients)
+{
+    nlohmann::json manifest = {{"company", company()}, {"clients", {{"acme", client("Acme", 95)}, {"beta", client("Beta", 80)}}}};
+    std::istringstream in(manifest.dump());
+    BulkSetupResult first = BulkSetup::apply(in);
+    EXPECT_TRUE(first.config_saved);
+    EXPECT_EQ(first.created, 2u);
+
+    AppConfig config = ConfigManager::load();
+    EXPECT_EQ(config.company.name, "Bulk Co");
+    EXPECT_EQ(config.company.currency, "EUR");
+    EXPECT_EQ(fs::path(config.company.logo_path).parent_path(), fs::path(ConfigManager::get_logos_dir()));
+    EXPECT_EQ(ClientRegistry::load().size(), 2u);
+
+    ClientManager::add_work_log("acme", "2026-02-02", 3.0, "Kickoff");
+
+    BulkSetupResult second = BulkSetup::apply(nlohmann::json{{"clients", {{"acme", {{"hourly_rate", 110}}}, {"beta", client("Beta", 80)}}}});
+    EXPECT_FALSE(second.config_saved);
+    EXPECT_EQ(second.created, 0u);
+    EXPECT_EQ(second.updated, 1u);
+    EXPECT_EQ(second.unchanged, 1u);
+
+    ClientData acme = ClientManager::load("acme");
+    EXPECT_DOUBLE_EQ(acme.hourly_rate, 110.0);
+    EXPECT_EQ(acme.name, "Acme");
+    EXPECT_EQ(acme.logs.size(), 1u);
+    EXPECT_DOUBLE_EQ(ClientRegistry::load()["acme"].hourly_rate, 110.0);
+}
+
+TEST_F(BulkSetupTest, ReportsEveryProblemAndWritesNothing)
+{
+    nlohmann::json bad = client("", -5);
+    bad["colour"] = "red";
+    nlohmann::json manifest = {{"clients", {{"ok", client("Okay", 50)}, {"bad/id", client("X", 1)}, {"bad", client("", -5)}, {"typo", bad}}}};
+
+    try
+    {
+        BulkSetup::apply(manifest);
+        FAIL() << "expected an error";
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::string message = e.what();
+        EXPECT_NE(message.find("company: no business configuration"), std::string::npos);
+        EXPECT_NE(message.find("clients.bad/id: Client id may only contain"), std::string::npos);
+        EXPECT_NE(message.find("clients.bad.name: This field is required."), std::string::npos);
+        EXPECT_NE(message.find("clients.bad.hourly_rate: Please enter a positive number."), std::string::npos);
+        EXPECT_NE(message.find("clients.typo.colour: unknown field"), std::string::npos);
+    }
+
+    EXPECT_FALSE(ConfigManager::config_exists());
+    EXPECT_FALSE(ClientManager::client_exists("ok"));
+
+    std::istringstream in("{ not json");
+    EXPECT_THROW(BulkSetup::apply(in), std::runtime_error);
+}
+
+TEST_F(BulkSetupTest, ValidationMatchesPrompts)
+{
+    double rate = 0.0;
+    EXPECT_EQ(Validation::positive_number("95.5", rate), "");
+    EXPECT_DOUBLE_EQ(rate, 95.5);
+    EXPECT_EQ(Validation::positive_number("-1", rate), "Please enter a positive number.");
+    EXPECT_EQ(Validation::positive_number("abc", rate), "Invalid number. Please try again.");
+
+    int days = 0;
+    EXPECT_EQ(Validation::positive_integer("30", days), "");
+    EXPECT_EQ(days, 30);
+    EXPECT_EQ(Validation::positive_integer("0", days), "Please enter a positive number.");
+
+    EXPECT_EQ(Validation::required(""), "This field is required.");
+    EXPECT_EQ(Validation::client_id("acme-2"), "");
+    EXPECT_NE(Validation::client_id("../etc"), "");
+    EXPECT_NE(Validation::logo_path(test_dir + "/missing.jpg"), "");
+}
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include "storage/client.hpp"
 #include "storage/config.hpp"
+#include "test_root.hpp"
 
 namespace fs = std::filesystem;
 
@@ -9,12 +10,13 @@ class ClientTest : public ::testing::Test
 {
 protected:
     std::string test_dir;
+    TestRoot root;
 
     void SetUp() override
     {
-        test_dir = fs::temp_directory_path() / "wlog_test_client";
+        test_dir = TestRoot::unique_dir("wlog_test_client");
         fs::create_directories(test_dir);
-        setenv("HOME", test_dir.c_str(), 1);
+        root.bind(test_dir);
         ConfigManager::ensure_directories();
     }
 
@@ -126,3 +128,123 @@ TEST_F(ClientTest, IncrementInvoiceNumber)
     ClientData loaded = ClientManager::load("invclient");
     EXPECT_EQ(loaded.next_invoice_number, 8);
 }
+
+class ShardedClientTest : public ClientTest
+{
+protected:
+    void SetUp() override
+    {
+        ClientTest::SetUp();
+        ClientManager::set_layout(ClientLayout::Sharded);
+    }
+
+    void TearDown() override
+    {
+        ClientManager::set_layout(ClientLayout::SingleFile);
+        ClientTest::TearDown();
+    }
+};
+
+TEST_F(ShardedClientTest, SaveWritesYearShards)
+{
+    ClientData client;
+    client.name = "Sharded Client";
+    client.tag = "SHD";
+    client.logs["2025-12"]["2025-12-01"] = {8.0, "Old work"};
+    client.logs["2026-01"]["2026-01-02"] = {6.0, "New work"};
+    ClientManager::save("shardclient", client);
+
+    EXPECT_TRUE(ClientManager::client_exists("shardclient"));
+    EXPECT_TRUE(ClientManager::is_sharded("shardclient"));
+    EXPECT_TRUE(fs::exists(ClientManager::get_shard_path("shardclient", "2025")));
+    EXPECT_TRUE(fs::exists(ClientManager::get_shard_path("shardclient", "2026")));
+
+    ClientData loaded = ClientManager::load("shardclient");
+    EXPECT_EQ(loaded.name, "Sharded Client");
+    EXPECT_EQ(loaded.logs["2025-12"]["2025-12-01"].message, "Old work");
+    EXPECT_EQ(loaded.logs["2026-01"]["2026-01-02"].hours, 6.0);
+}
+
+TEST_F(ShardedClientTest, MigratesSingleFileOnFirstWrite)
+{
+    ClientManager::set_layout(ClientLayout::SingleFile);
+    ClientData client;
+    client.name = "Legacy Client";
+    client.tag = "LEG";
+    client.logs["2025-06"]["2025-06-10"] = {5.0, "Legacy work"};
+    ClientManager::save("legacyclient", client);
+    ASSERT_FALSE(ClientManager::is_sharded("legacyclient"));
+
+    ClientManager::set_layout(ClientLayout::Sharded);
+    ClientManager::add_work_log("legacyclient", "2026-01-05", 8.0, "After migration");
+
+    EXPECT_TRUE(ClientManager::is_sharded("legacyclient"));
+    EXPECT_FALSE(fs::exists(ClientManager::get_client_path("legacyclient")));
+
+    ClientData loaded = ClientManager::load("legacyclient");
+    EXPECT_EQ(loaded.logs["2025-06"]["2025-06-10"].hours, 5.0);
+    EXPECT_EQ(loaded.logs["2026-01"]["2026-01-05"].hours, 8.0);
+}
+
+TEST_F(ShardedClientTest, AddWorkLogOnlyTouchesItsYear)
+{
+    ClientData client;
+    client.name = "Year Client";
+    client.tag = "YRC";
+    client.logs["2025-03"]["2025-03-03"] = {7.0, "Last year"};
+    ClientManager::save("yearclient", client);
+
+    auto old_shard = ClientManager::get_shard_path("yearclient", "2025");
+    auto old_time = fs::last_write_time(old_shard);
+
+    ClientManager::add_work_log("yearclient", "2026-02-01", 4.0, "This year");
+
+    EXPECT_EQ(fs::last_write_time(old_shard), old_time);
+    EXPECT_TRUE(fs::exists(ClientManager::get_shard_path("yearclient", "2026")));
+}
+
+TEST_F(ShardedClientTest, MonthLoadReadsSingleShard)
+{
+    ClientData client;
+    client.name = "Month Client";
+    client.tag = "MON";
+    client.logs["2025-03"]["2025-03-03"] = {7.0, "Last year"};
+    client.logs["2026-02"]["2026-02-03"] = {3.0, "This year"};
+    ClientManager::save("monthclient", client);
+
+    ClientData loaded = ClientManager::load("monthclient", "2026-02");
+    EXPECT_EQ(loaded.name, "Month Client");
+    EXPECT_EQ(loaded.logs.count("2025-03"), 0u);
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(loaded, "2026-02"), 3.0);
+}
+
+TEST_F(ShardedClientTest, IncrementInvoiceNumberKeepsShards)
+{
+    ClientData client;
+    client.name = "Invoice Shard";
+    client.tag = "ISH";
+    client.next_invoice_number = 3;
+    client.logs["2026-01"]["2026-01-01"] = {1.0, "Work"};
+    ClientManager::save("invshard", client);
+
+    EXPECT_EQ(ClientManager::increment_invoice_number("invshard"), 3);
+
+    ClientData loaded = ClientManager::load("invshard");
+    EXPECT_EQ(loaded.next_invoice_number, 4);
+    EXPECT_EQ(loaded.logs["2026-01"]["2026-01-01"].hours, 1.0);
+}
+
+TEST_F(ShardedClientTest, RangeLoadReadsOnlyYearsInRange)
+{
+    ClientData client;
+    client.name = "Range Client";
+    client.tag = "RNG";
+    client.logs["2024-06"]["2024-06-03"] = {2.0, "Two years ago"};
+    client.logs["2025-11"]["2025-11-03"] = {7.0, "Last year"};
+    client.logs["2026-01"]["2026-01-05"] = {3.0, "This year"};
+    ClientManager::save("rangeclient", client);
+
+    ClientData loaded = ClientManager::load("rangeclient", Calendar::Date(2025, 11, 1), Calendar::Date(2026, 1, 31));
+    EXPECT_EQ(loaded.logs.count("2024-06"), 0u);
+    EXPECT_DOUBLE_EQ(loaded.logs.between(Calendar::Date(2025, 11, 1), Calendar::Date(2026, 1, 31)).total_hours(), 10.0);
+}
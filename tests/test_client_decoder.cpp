@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/client_decoder.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class ClientDecoderTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+    ClientData client;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_decoder");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        client.name = "Decoder \"Quoted\" B.V.";
+        client.address_line1 = "Straße 1";
+        client.hourly_rate = 92.5;
+        client.payment_term_days = 30;
+        client.tag = "DEC";
+        client.next_invoice_number = 7;
+        client.archived_months = {"2024-11", "2024-12"};
+        client.logs["2025-01"]["2025-01-02"] = {8.0, "Kickoff\nwith \\ escapes"};
+        client.logs["2025-01"]["2025-01-03"] = {2.5, "Standup"};
+        client.logs["2026-02"]["2026-02-10"] = {4.0, "Standup"};
+        client.logs["2026-02"]["2026-02-11"] = {1.0, ""};
+    }
+
+    void TearDown() override
+    {
+        ClientDecoder::set_on_demand(false);
+        WorkLogTable::set_encoding(MessageEncoding::Inline);
+        fs::remove_all(test_dir);
+    }
+
+    void expect_same(const ClientData &decoded)
+    {
+        EXPECT_EQ(decoded.name, client.name);
+        EXPECT_EQ(decoded.address_line1, client.address_line1);
+        EXPECT_EQ(decoded.address_line2, client.address_line2);
+        EXPECT_DOUBLE_EQ(decoded.hourly_rate, client.hourly_rate);
+        EXPECT_EQ(decoded.payment_term_days, client.payment_term_days);
+        EXPECT_EQ(decoded.tag, client.tag);
+        EXPECT_EQ(decoded.next_invoice_number, client.next_invoice_number);
+        EXPECT_EQ(decoded.archived_months, client.archived_months);
+        ASSERT_EQ(decoded.logs.size(), client.logs.size());
+        for (size_t i = 0; i < client.logs.size(); i++)
+        {
+            EXPECT_EQ(decoded.logs.row(i).date, client.logs.row(i).date);
+            EXPECT_DOUBLE_EQ(decoded.logs.row(i).hours, client.logs.row(i).hours);
+            EXPECT_EQ(decoded.logs.row(i).message, client.logs.row(i).message);
+        }
+    }
+};
+
+TEST_F(ClientDecoderTest, OnDemandMatchesDomForBothEncodings)
+{
+    ClientDecoder::set_on_demand(true);
+    for (MessageEncoding encoding : {MessageEncoding::Inline, MessageEncoding::Dictionary})
+    {
+        WorkLogTable::set_encoding(encoding);
+        std::string contents = nlohmann::json(client).dump(2);
+        expect_same(ClientDecoder::decode_client(contents));
+
+        std::string logs = nlohmann::json(client.logs).dump();
+        WorkLogTable table = ClientDecoder::decode_logs(logs);
+        EXPECT_DOUBLE_EQ(table.all().total_hours(), 15.5);
+    }
+
+    std::string broken = "{\"name\": \"Unterminated";
+    EXPECT_ANY_THROW(ClientDecoder::decode_client(broken));
+    std::string bad_index = "{\"2025-01\": {\"2025-01-02\": {\"hours\": 1.0, \"message\": 3}}, \"messages\": [\"a\"]}";
+    EXPECT_ANY_THROW(ClientDecoder::decode_logs(bad_index));
+}
+
+TEST_F(ClientDecoderTest, StorageLoadsOnDemand)
+{
+    ClientManager::save("single", client);
+    ClientManager::set_layout(ClientLayout::Sharded);
+    ClientManager::save("sharded", client);
+
+    ClientDecoder::set_on_demand(true);
+    expect_same(ClientManager::load("single"));
+    expect_same(ClientManager::load("sharded"));
+
+    ClientData month = ClientManager::load("sharded", "2026-02");
+    EXPECT_EQ(month.name, client.name);
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(month, "2026-02"), 5.0);
+    EXPECT_EQ(month.logs.count("2025-01"), 0u);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/client_encoder.hpp"
+#include "storage/durable_file.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class ClientEncoderTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+    ClientData client;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_encoder");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        client.name = "Encoder \"Quoted\" B.V.";
+        client.address_line1 = "Straße 1 \xf0\x9f\x93\x8e";
+        client.hourly_rate = 92.5;
+        client.payment_term_days = 30;
+        client.tag = "ENC";
+        client.next_invoice_number = 12;
+        client.archived_months = {"2024-11", "2024-12"};
+        client.logs["2025-01"]["2025-01-02"] = {8.0, "Kickoff\nwith \\ escapes\t\x01"};
+        client.logs["2025-01"]["2025-01-03"] = {0.1, "Standup"};
+        client.logs["2026-02"]["2026-02-10"] = {12345.678, "Standup"};
+        client.logs["2026-02"]["2026-02-11"] = {1e-7, ""};
+    }
+
+    void TearDown() override
+    {
+        ClientEncoder::set_format(JsonFormat::Pretty);
+        WorkLogTable::set_encoding(MessageEncoding::Inline);
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(ClientEncoderTest, MatchesNlohmannOutput)
+{
+    for (MessageEncoding encoding : {MessageEncoding::Inline, MessageEncoding::Dictionary})
+    {
+        WorkLogTable::set_encoding(encoding);
+        nlohmann::json j = client;
+        EXPECT_EQ(ClientEncoder::encode_client(client, JsonFormat::Pretty), j.dump(2));
+        EXPECT_EQ(ClientEncoder::encode_client(client, JsonFormat::Compact), j.dump());
+
+        nlohmann::json logs = client.logs;
+        EXPECT_EQ(ClientEncoder::encode_logs(client.logs.all()), logs.dump(2));
+
+        j.erase("logs");
+        j["shards"] = std::set<std::string>{"2025", "2026"};
+        EXPECT_EQ(ClientEncoder::encode_meta(client, {"2025", "2026"}), j.dump(2));
+    }
+
+    EXPECT_EQ(ClientEncoder::encode_client(ClientData{}), nlohmann::json(ClientData{}).dump(2));
+}
+
+TEST_F(ClientEncoderTest, CompactFilesLoadBack)
+{
+    ClientEncoder::set_format(JsonFormat::Compact);
+    ClientManager::save("compact", client);
+
+    std::string contents;
+    ASSERT_TRUE(DurableFile::read(ClientManager::get_client_path("compact"), contents));
+    EXPECT_EQ(contents.find('\n'), std::string::npos);
+
+    ClientData loaded = ClientManager::load("compact");
+    EXPECT_EQ(loaded.name, client.name);
+    EXPECT_EQ(loaded.address_line1, client.address_line1);
+    EXPECT_EQ(loaded.logs["2025-01"]["2025-01-02"].message, "Kickoff\nwith \\ escapes\t\x01");
+    EXPECT_DOUBLE_EQ(loaded.logs["2026-02"]["2026-02-10"].hours, 12345.678);
+
+    ClientData broken = client;
+    broken.logs["2026-03"]["2026-03-02"] = {1.0, "Bad \xff byte"};
+    EXPECT_THROW(ClientManager::save("broken", broken), std::runtime_error);
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include <filesystem>
 #include <fstream>
+#include <thread>
 #include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "test_root.hpp"
 
 namespace fs = std::filesystem;
 
@@ -9,14 +12,14 @@ class ConfigTest : public ::testing::Test
 {
 protected:
     std::string test_dir;
+    TestRoot root;
 
     void SetUp() override
     {
-        test_dir = fs::temp_directory_path() / "wlog_test";
+        test_dir = TestRoot::unique_dir("wlog_test");
         fs::create_directories(test_dir);
 
-        // Set HOME to test directory for isolation
-        setenv("HOME", test_dir.c_str(), 1);
+        root.bind(test_dir);
     }
 
     void TearDown() override
@@ -31,6 +34,43 @@ TEST_F(ConfigTest, GetConfigDir)
     EXPECT_EQ(config_dir, test_dir + "/.wlog");
 }
 
+TEST_F(ConfigTest, DefaultRootIsHome)
+{
+    DataRoot::Scope none(nullptr);
+    EXPECT_EQ(ConfigManager::get_config_dir(), std::string(std::getenv("HOME")) + "/.wlog");
+}
+
+TEST_F(ConfigTest, RootsAreServedConcurrently)
+{
+    auto save_and_load = [&](const std::string &name, std::string &loaded)
+    {
+        DataRoot root(test_dir + "/" + name, ClientLayout::Sharded);
+        DataRoot::Scope scope(&root);
+        AppConfig config;
+        config.company.name = name;
+        for (int i = 0; i < 20; i++)
+        {
+            ConfigManager::save(config);
+            ClientData client;
+            client.name = name;
+            client.logs["2026-01"]["2026-01-05"] = {static_cast<double>(i), name};
+            ClientManager::save("shared", client);
+        }
+        loaded = ConfigManager::load().company.name + "/" + ClientManager::load("shared").name;
+    };
+
+    std::string first, second;
+    std::thread a(save_and_load, "first", std::ref(first));
+    std::thread b(save_and_load, "second", std::ref(second));
+    a.join();
+    b.join();
+
+    EXPECT_EQ(first, "first/first");
+    EXPECT_EQ(second, "second/second");
+    EXPECT_TRUE(fs::is_directory(test_dir + "/first/clients/shared"));
+    EXPECT_FALSE(ConfigManager::config_exists());
+}
+
 TEST_F(ConfigTest, ConfigNotExistsInitially)
 {
     EXPECT_FALSE(ConfigManager::config_exists());
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "calendar/date.hpp"
+
+using Calendar::Date;
+
+static_assert(Calendar::parse_date("2024-02-29") == Date(2024, 2, 29));
+static_assert(!Calendar::parse_date("2023-02-29").valid());
+static_assert(Calendar::add_months(Date(2026, 1, 0), -1) == Date(2025, 12, 0));
+
+TEST(DateTest, ParsesAndValidatesDays)
+{
+    EXPECT_EQ(Calendar::parse_date("2026-01-15").value, 20260115u);
+    EXPECT_FALSE(Calendar::parse_date("2026-13-01").valid());
+    EXPECT_FALSE(Calendar::parse_date("2026-04-31").valid());
+    EXPECT_FALSE(Calendar::parse_date("1900-02-29").valid());
+    EXPECT_TRUE(Calendar::parse_date("2000-02-29").valid());
+    EXPECT_FALSE(Calendar::parse_date("20260115").valid());
+    EXPECT_FALSE(Calendar::parse_date("2026-1-15x").valid());
+}
+
+TEST(DateTest, ParsesMonthKeys)
+{
+    Date month = Calendar::parse_month("2026-03");
+    EXPECT_EQ(month.value, 20260300u);
+    EXPECT_EQ(month.month_start(), month);
+    EXPECT_EQ(Date(2026, 3, 17).month_start(), month);
+    EXPECT_FALSE(Calendar::parse_month("2026-00").valid());
+}
+
+TEST(DateTest, AddsMonthsAcrossYears)
+{
+    EXPECT_EQ(Calendar::add_months(Date(2026, 1, 15), -1), Date(2025, 12, 15));
+    EXPECT_EQ(Calendar::add_months(Date(2025, 11, 0), 14), Date(2027, 1, 0));
+    EXPECT_EQ(Calendar::add_months(Date(2026, 1, 31), 1), Date(2026, 2, 28));
+    EXPECT_EQ(Calendar::add_months(Date(2024, 3, 31), -1), Date(2024, 2, 29));
+}
+
+TEST(DateTest, ComputesDueDates)
+{
+    EXPECT_EQ(Calendar::due_date(Date(2026, 1, 20), 14), Date(2026, 2, 3));
+    EXPECT_EQ(Calendar::due_date(Date(2024, 2, 20), 10), Date(2024, 3, 1));
+    EXPECT_EQ(Calendar::due_date(Date(2025, 12, 25), 30), Date(2026, 1, 24));
+    EXPECT_EQ(Calendar::to_days(Date(1970, 1, 1)), 0);
+    EXPECT_EQ(Calendar::from_days(Calendar::to_days(Date(2026, 7, 4))), Date(2026, 7, 4));
+    EXPECT_EQ(Calendar::weekday(Date(2026, 1, 5)), 0);
+}
+
+TEST(DateTest, FormatsWithoutAllocating)
+{
+    Date date(2026, 1, 5);
+    EXPECT_EQ(Calendar::iso(date).view(), "2026-01-05");
+    EXPECT_EQ(Calendar::month_key(date).view(), "2026-01");
+    EXPECT_EQ(Calendar::short_date(date).view(), "Jan 05");
+    EXPECT_EQ(Calendar::long_date(date).view(), "Jan 05, 2026");
+    EXPECT_EQ(Calendar::month_title(date).view(), "January 2026");
+}
+
+TEST(DateTest, TodayIsValid)
+{
+    Date today = Calendar::today();
+    EXPECT_TRUE(Calendar::is_valid(today.year(), today.month(), today.day()));
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/durable_file.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+static size_t temp_files(const std::string &dir)
+{
+    size_t count = 0;
+    for (const auto &entry : fs::recursive_directory_iterator(dir))
+        count += entry.path().extension() == ".tmp";
+    return count;
+}
+
+class DurableFileTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_durable");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+        DurableFile::set_policy(DurabilityPolicy::PerBatch);
+    }
+
+    void TearDown() override
+    {
+        DurableFile::set_policy(DurabilityPolicy::PerBatch);
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(DurableFileTest, WriteAndReadBack)
+{
+    std::string path = test_dir + "/file.json";
+    DurableFile::write(path, "{\"a\": 1}");
+
+    std::string contents;
+    ASSERT_TRUE(DurableFile::read(path, contents));
+    EXPECT_EQ(contents, "{\"a\": 1}");
+    EXPECT_EQ(temp_files(test_dir), 0u);
+}
+
+TEST_F(DurableFileTest, ReadMissingFileFails)
+{
+    std::string contents;
+    EXPECT_FALSE(DurableFile::read(test_dir + "/missing.json", contents));
+}
+
+TEST_F(DurableFileTest, BatchDefersWritesUntilCommit)
+{
+    std::string path = test_dir + "/batched.json";
+
+    WriteBatch batch;
+    DurableFile::write(path, "first");
+    DurableFile::write(path, "second");
+
+    EXPECT_FALSE(fs::exists(path));
+    EXPECT_TRUE(DurableFile::exists(path));
+
+    std::string contents;
+    ASSERT_TRUE(DurableFile::read(path, contents));
+    EXPECT_EQ(contents, "second");
+
+    batch.commit();
+    EXPECT_TRUE(fs::exists(path));
+}
+
+TEST_F(DurableFileTest, UncommittedBatchIsDiscarded)
+{
+    std::string path = test_dir + "/discarded.json";
+    {
+        WriteBatch batch;
+        DurableFile::write(path, "lost");
+    }
+    EXPECT_FALSE(DurableFile::exists(path));
+}
+
+TEST_F(DurableFileTest, NestedBatchJoinsOuter)
+{
+    std::string path = test_dir + "/nested.json";
+
+    WriteBatch outer;
+    {
+        WriteBatch inner;
+        DurableFile::write(path, "nested");
+        inner.commit();
+    }
+    EXPECT_FALSE(fs::exists(path));
+
+    outer.commit();
+    EXPECT_TRUE(fs::exists(path));
+}
+
+TEST_F(DurableFileTest, PerWriteIgnoresBatch)
+{
+    DurableFile::set_policy(DurabilityPolicy::PerWrite);
+    std::string path = test_dir + "/immediate.json";
+
+    WriteBatch batch;
+    DurableFile::write(path, "now");
+    EXPECT_TRUE(fs::exists(path));
+}
+
+TEST_F(DurableFileTest, BatchedWorkLogsCoalesce)
+{
+    ClientData client;
+    client.name = "Batch Client";
+    client.tag = "BAT";
+    ClientManager::save("batchclient", client);
+
+    WriteBatch batch;
+    ClientManager::add_work_log("batchclient", "2026-01-05", 8.0, "Day 1");
+    ClientManager::add_work_log("batchclient", "2026-01-06", 6.0, "Day 2");
+    batch.commit();
+
+    ClientData loaded = ClientManager::load("batchclient");
+    EXPECT_DOUBLE_EQ(ClientManager::get_month_total_hours(loaded, "2026-01"), 14.0);
+}
+
+TEST_F(DurableFileTest, DurabilityStoredInConfig)
+{
+    AppConfig config;
+    config.storage.durability = DurabilityPolicy::None;
+    ConfigManager::save(config);
+
+    AppConfig loaded = ConfigManager::load();
+    EXPECT_EQ(loaded.storage.durability, DurabilityPolicy::None);
+}
+
+TEST_F(DurableFileTest, BatchDefersRemoval)
+{
+    std::string path = test_dir + "/removed.json";
+    DurableFile::write(path, "present");
+
+    WriteBatch batch;
+    DurableFile::remove(path);
+    EXPECT_FALSE(DurableFile::exists(path));
+    EXPECT_TRUE(fs::exists(path));
+
+    batch.commit();
+    EXPECT_FALSE(fs::exists(path));
+}
+
+TEST_F(DurableFileTest, FailedCommitLeavesNoTempFiles)
+{
+    WriteBatch batch;
+    DurableFile::write(test_dir + "/a.json", "written first");
+    DurableFile::write(test_dir + "/missing/b.json", "cannot be written");
+
+    EXPECT_THROW(batch.commit(), std::runtime_error);
+    EXPECT_FALSE(fs::exists(test_dir + "/a.json"));
+    EXPECT_EQ(temp_files(test_dir), 0u);
+}
+
+TEST_F(DurableFileTest, ConcurrentWritersUseOwnTempFiles)
+{
+    DurableFile::set_policy(DurabilityPolicy::None);
+    std::string path = test_dir + "/shared.json";
+    std::atomic<int> failures{0};
+    auto writer = [&](size_t size, char fill) {
+        for (int i = 0; i < 2000; i++)
+        {
+            try
+            {
+                DurableFile::write(path, std::string(size, fill));
+            }
+            catch (const std::exception &)
+            {
+                failures++;
+            }
+        }
+    };
+    std::thread first(writer, 64 * 1024, 'a');
+    std::thread second(writer, 1024, 'b');
+    first.join();
+    second.join();
+
+    EXPECT_EQ(failures, 0);
+    std::string contents;
+    ASSERT_TRUE(DurableFile::read(path, contents));
+    EXPECT_EQ(contents, std::string(contents[0] == 'a' ? 64 * 1024 : 1024, contents[0]));
+    EXPECT_EQ(temp_files(test_dir), 0u);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <nlohmann/json.hpp>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/archive.hpp"
+#include "export/exporter.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class ExportTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_export");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        ClientData acme;
+        acme.name = "Acme";
+        acme.logs["2024-03"]["2024-03-04"] = {2.5, "Old, \"quoted\" work"};
+        acme.logs["2026-01"]["2026-01-05"] = {8.0, "Review"};
+        acme.logs["2026-01"]["2026-01-06"] = {4.0, "Review"};
+        ClientManager::save("acme", acme);
+        ArchiveManager::archive_client("acme", "2025-01");
+
+        ClientData beta;
+        beta.name = "Beta";
+        beta.logs["2026-02"]["2026-02-02"] = {1.0, "Line one\nline two"};
+        ClientManager::save("beta", beta);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+};
+
+static uint32_t read_u32(const std::string &data, size_t &pos)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos++])) << (8 * i);
+    return value;
+}
+
+TEST_F(ExportTest, CsvCoversArchiveAndQuotesFields)
+{
+    std::ostringstream out;
+    EXPECT_EQ(Exporter::write(out, ExportFormat::Csv), 4u);
+    EXPECT_EQ(out.str(),
+              "client,date,hours,message\n"
+              "acme,2024-03-04,2.5,\"Old, \"\"quoted\"\" work\"\n"
+              "acme,2026-01-05,8,Review\n"
+              "acme,2026-01-06,4,Review\n"
+              "beta,2026-02-02,1,\"Line one\nline two\"\n");
+}
+
+TEST_F(ExportTest, JsonlRowsRoundTrip)
+{
+    std::ostringstream out;
+    Exporter::write(out, ExportFormat::Jsonl, {"beta", "acme"});
+
+    std::istringstream lines(out.str());
+    std::vector<nlohmann::json> rows;
+    std::string line;
+    while (std::getline(lines, line))
+        rows.push_back(nlohmann::json::parse(line));
+
+    ASSERT_EQ(rows.size(), 4u);
+    EXPECT_EQ(rows[0]["client"], "beta");
+    EXPECT_EQ(rows[0]["message"], "Line one\nline two");
+    EXPECT_EQ(rows[1]["message"], "Old, \"quoted\" work");
+    EXPECT_DOUBLE_EQ(rows[3]["hours"].get<double>(), 4.0);
+}
+
+TEST_F(ExportTest, ColumnarBlocksShareDictionary)
+{
+    std::ostringstream out;
+    Exporter::write(out, ExportFormat::Columnar, {"acme"});
+    std::string data = out.str();
+
+    ASSERT_EQ(data.compare(0, 8, "WLOGCOL1"), 0);
+    size_t pos = 8;
+    uint32_t id_size = read_u32(data, pos);
+    EXPECT_EQ(data.substr(pos, id_size), "acme");
+    pos += id_size;
+
+    uint32_t rows = read_u32(data, pos);
+    uint32_t messages = read_u32(data, pos);
+    ASSERT_EQ(rows, 3u);
+    EXPECT_EQ(messages, 2u);
+
+    EXPECT_EQ(read_u32(data, pos), 20240304u);
+    EXPECT_EQ(read_u32(data, pos), 20260105u);
+    EXPECT_EQ(read_u32(data, pos), 20260106u);
+
+    double hours = 0.0;
+    std::memcpy(&hours, data.data() + pos, sizeof(hours));
+    EXPECT_DOUBLE_EQ(hours, 2.5);
+    pos += 3 * sizeof(double);
+
+    EXPECT_EQ(read_u32(data, pos), 0u);
+    EXPECT_EQ(read_u32(data, pos), 1u);
+    EXPECT_EQ(read_u32(data, pos), 1u);
+
+    uint32_t size = read_u32(data, pos);
+    EXPECT_EQ(data.substr(pos, size), "Old, \"quoted\" work");
+    pos += size;
+    size = read_u32(data, pos);
+    EXPECT_EQ(data.substr(pos, size), "Review");
+    pos += size;
+
+    EXPECT_EQ(read_u32(data, pos), 0u);
+    EXPECT_EQ(pos, data.size());
+}
+
+TEST_F(ExportTest, RejectsUnknownFormatsAndClients)
+{
+    EXPECT_EQ(Exporter::parse_format("jsonl"), ExportFormat::Jsonl);
+    EXPECT_THROW(Exporter::parse_format("xlsx"), std::runtime_error);
+
+    std::ostringstream out;
+    EXPECT_THROW(Exporter::write(out, ExportFormat::Csv, {"missing"}), std::runtime_error);
+}
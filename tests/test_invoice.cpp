@@ -3,6 +3,7 @@
 #include "storage/config.hpp"
 #include "storage/client.hpp"
 #include "invoice/generator.hpp"
+#include "test_root.hpp"
 
 namespace fs = std::filesystem;
 
@@ -10,14 +11,15 @@ class InvoiceTest : public ::testing::Test
 {
 protected:
     std::string test_dir;
+    TestRoot root;
     std::string original_cwd;
     std::string prev_month;
 
     void SetUp() override
     {
-        test_dir = fs::temp_directory_path() / "wlog_test_invoice";
+        test_dir = TestRoot::unique_dir("wlog_test_invoice");
         fs::create_directories(test_dir);
-        setenv("HOME", test_dir.c_str(), 1);
+        root.bind(test_dir);
 
         // Save current directory and change to test dir for PDF output
         original_cwd = fs::current_path();
@@ -110,3 +112,46 @@ TEST_F(InvoiceTest, CalculationsCorrect)
     std::string output = InvoiceGenerator::generate("invoiceclient");
     EXPECT_TRUE(fs::exists(test_dir + "/" + output));
 }
+
+TEST_F(InvoiceTest, GeneratesAllClientsWithHours)
+{
+    ClientData second;
+    second.name = "Second Client";
+    second.tag = "SEC";
+    second.hourly_rate = 60.0;
+    second.logs[prev_month][prev_month + "-03"] = {2.5, "Call"};
+    ClientManager::save("second", second);
+
+    ClientData idle;
+    idle.name = "Idle Client";
+    idle.tag = "IDL";
+    ClientManager::save("idle", idle);
+
+    std::vector<std::string> outputs = InvoiceGenerator::generate_all();
+
+    ASSERT_EQ(outputs.size(), 2u);
+    EXPECT_EQ(outputs[0], "ITC-ICL-" + prev_month + ".pdf");
+    EXPECT_EQ(outputs[1], "ITC-SEC-" + prev_month + ".pdf");
+    for (const auto &output : outputs)
+        EXPECT_TRUE(fs::exists(test_dir + "/" + output));
+    EXPECT_FALSE(fs::exists(test_dir + "/ITC-IDL-" + prev_month + ".pdf"));
+}
+
+TEST_F(InvoiceTest, TemplateOnlyDependsOnCompany)
+{
+    AppConfig config = ConfigManager::load();
+    ClientData client = ClientManager::load("invoiceclient");
+    InvoiceData data = InvoiceGenerator::prepare_data(config, client, prev_month, 20.0);
+    InvoiceTemplate layout(data);
+
+    InvoiceData other = data;
+    other.client_name = "Someone Else";
+    other.total = 1.0;
+    other.payment_term_days = 60;
+    EXPECT_TRUE(layout.matches(other));
+
+    other.company_bank = "NL00OTHER0000000000";
+    EXPECT_FALSE(layout.matches(other));
+
+    EXPECT_EQ(layout.format_currency(1936), "\x80 1936.00");
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "merge/team_merge.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class MergeTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+    std::string original_cwd;
+    std::vector<MergeSource> roots;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_merge");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        original_cwd = fs::current_path();
+        fs::current_path(test_dir);
+
+        AppConfig config;
+        config.company.name = "Merge Co";
+        config.company.tag = "MC";
+        ConfigManager::save(config);
+
+        ClientData alice;
+        alice.name = "Acme";
+        alice.hourly_rate = 100.0;
+        alice.tag = "ACM";
+        alice.logs["2026-02"]["2026-02-02"] = {4.0, "Kickoff"};
+        alice.logs["2026-02"]["2026-02-05"] = {3.0, "API design"};
+        alice.logs["2026-03"]["2026-03-01"] = {9.0, "Next month"};
+        save_root("alice", "acme", alice);
+
+        ClientData bob;
+        bob.name = "Acme Corp";
+        bob.hourly_rate = 90.0;
+        bob.logs["2026-02"]["2026-02-02"] = {2.0, "Kickoff notes"};
+        bob.logs["2026-02"]["2026-02-03"] = {6.0, "Frontend"};
+        save_root("bob", "acme", bob);
+
+        ClientData carol;
+        carol.name = "Other";
+        save_root("carol", "other", carol);
+
+        for (const char *author : {"alice", "bob", "carol"})
+            roots.push_back(TeamMerge::parse_source((fs::path(test_dir) / author / ".wlog").string()));
+    }
+
+    void save_root(const std::string &author, const std::string &client_id, const ClientData &client)
+    {
+        DataRoot other((fs::path(test_dir) / author / ".wlog").string());
+        DataRoot::Scope scope(&other);
+        ConfigManager::ensure_directories();
+        ClientManager::save(client_id, client);
+    }
+
+    void TearDown() override
+    {
+        fs::current_path(original_cwd);
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(MergeTest, ParsesRootsWithAndWithoutAuthor)
+{
+    EXPECT_EQ(roots[0].author, "alice");
+    EXPECT_EQ(roots[1].author, "bob");
+
+    MergeSource named = TeamMerge::parse_source("robert=" + roots[1].dir);
+    EXPECT_EQ(named.author, "robert");
+    EXPECT_EQ(named.dir, roots[1].dir);
+
+    EXPECT_THROW(TeamMerge::parse_source(test_dir + "/nobody"), std::runtime_error);
+}
+
+TEST_F(MergeTest, MergesMonthInDateOrderTaggedByAuthor)
+{
+    std::vector<std::string> merged;
+    ClientData client = TeamMerge::merge_month(roots, "acme", "2026-02", [&](const MergedEntry &entry)
+    {
+        merged.push_back(Calendar::iso(entry.date).str() + " " + *entry.author + " " + std::string(entry.message));
+    });
+
+    EXPECT_EQ(client.name, "Acme");
+    EXPECT_DOUBLE_EQ(client.hourly_rate, 100.0);
+    EXPECT_TRUE(client.logs.empty());
+
+    std::vector<std::string> expected = {
+        "2026-02-02 alice Kickoff",
+        "2026-02-02 bob Kickoff notes",
+        "2026-02-03 bob Frontend",
+        "2026-02-05 alice API design",
+    };
+    EXPECT_EQ(merged, expected);
+
+    EXPECT_THROW(TeamMerge::merge_month(roots, "nobody", "2026-02", [](const MergedEntry &) {}),
+                 std::runtime_error);
+}
+
+TEST_F(MergeTest, GeneratesConsolidatedDocuments)
+{
+    std::string report = TeamMerge::generate_report(roots, "acme", "2026-02");
+    EXPECT_EQ(report, "worklog-acme-2026-02.pdf");
+    EXPECT_TRUE(fs::exists(report));
+
+    std::string invoice = TeamMerge::generate_invoice(roots, "acme", "2026-02");
+    EXPECT_EQ(invoice, "MC-ACM-2026-02.pdf");
+    EXPECT_TRUE(fs::exists(invoice));
+
+    EXPECT_THROW(TeamMerge::generate_invoice(roots, "acme", "2026-01"), std::runtime_error);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "pipeline/pipeline.hpp"
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class PipelineTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_pipeline");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        ClientData acme;
+        acme.name = "Acme";
+        acme.hourly_rate = 100.0;
+        acme.logs["2026-01"]["2026-01-30"] = {1.0, "January"};
+        acme.logs["2026-02"]["2026-02-02"] = {4.0, "Kickoff"};
+        acme.logs["2026-02"]["2026-02-03"] = {2.5, "Standup and review"};
+        acme.logs["2026-02"]["2026-02-10"] = {3.5, "Review"};
+        acme.logs["2026-03"]["2026-03-01"] = {8.0, "March"};
+        ClientManager::save("acme", acme);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+};
+
+class RecordingSink : public Pipeline::Sink
+{
+public:
+    std::vector<std::string> events;
+
+    void begin(const ClientData &client) override { events.push_back("begin " + client.name); }
+    void row(const WorkLogRow &row) override { events.push_back(Calendar::iso(row.date).str()); }
+    void finish(const Pipeline::Summary &summary) override
+    {
+        events.push_back("finish " + std::to_string(summary.entries));
+    }
+};
+
+TEST_F(PipelineTest, TotalsOnlyMatchRowByRow)
+{
+    Pipeline::Source source = Pipeline::Source::month("acme", "2026-02");
+    Pipeline::Summary totals = source.totals();
+    EXPECT_EQ(totals.entries, 3u);
+    EXPECT_DOUBLE_EQ(totals.hours, 10.0);
+    EXPECT_DOUBLE_EQ(totals.amounts.subtotal, 1000.0);
+    EXPECT_EQ(source.client().name, "Acme");
+
+    RecordingSink sink;
+    Pipeline::Summary rows = Pipeline::Source::month("acme", "2026-02").run(sink);
+    EXPECT_DOUBLE_EQ(rows.hours, totals.hours);
+
+    std::vector<std::string> expected = {"begin Acme", "2026-02-02", "2026-02-03", "2026-02-10", "finish 3"};
+    EXPECT_EQ(sink.events, expected);
+}
+
+TEST_F(PipelineTest, FiltersApplyBeforeAggregation)
+{
+    Pipeline::Source source("acme", Calendar::Date(2026, 1, 1), Calendar::Date(2026, 3, 31));
+    source.filter([](const WorkLogRow &row) { return row.message.find("eview") != std::string_view::npos; })
+        .filter([](const WorkLogRow &row) { return row.hours < 3.0; });
+
+    RecordingSink sink;
+    Pipeline::Summary summary = source.run(sink);
+    EXPECT_EQ(summary.entries, 1u);
+    EXPECT_DOUBLE_EQ(summary.hours, 2.5);
+    EXPECT_EQ(sink.events[1], "2026-02-03");
+
+    EXPECT_DOUBLE_EQ(source.totals().hours, 2.5);
+}
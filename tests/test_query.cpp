@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/archive.hpp"
+#include "query/query.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class QueryTest : public ::testing::Test
+{
+protected:
+    std::map<std::string, ClientData> clients;
+
+    void SetUp() override
+    {
+        ClientData acme;
+        acme.tag = "ACME";
+        acme.hourly_rate = 100.0;
+        acme.logs.set("2025-01-06", 8.0, "Mon");
+        acme.logs.set("2025-01-07", 6.0, "Tue");
+        acme.logs.set("2025-02-03", 4.0, "Mon");
+        acme.logs.set("2026-01-05", 2.0, "Mon");
+        clients["acme"] = acme;
+
+        ClientData beta;
+        beta.tag = "BETA";
+        beta.hourly_rate = 50.0;
+        beta.logs.set("2025-01-06", 2.0, "Mon");
+        beta.logs.set("2025-02-04", 3.0, "Tue");
+        clients["beta"] = beta;
+    }
+};
+
+TEST_F(QueryTest, SumsByMonthForTag)
+{
+    auto result = Query::run(Query::parse("sum(hours), count where tag = ACME and year = 2025 by month"), clients, 2);
+
+    EXPECT_EQ(result.key_names, std::vector<std::string>{"month"});
+    EXPECT_EQ(result.value_names, (std::vector<std::string>{"sum(hours)", "count"}));
+    ASSERT_EQ(result.rows.size(), 2u);
+    EXPECT_EQ(result.rows[0].keys[0], "2025-01");
+    EXPECT_DOUBLE_EQ(result.rows[0].values[0], 14.0);
+    EXPECT_DOUBLE_EQ(result.rows[0].values[1], 2.0);
+    EXPECT_EQ(result.rows[1].keys[0], "2025-02");
+    EXPECT_DOUBLE_EQ(result.rows[1].values[0], 4.0);
+}
+
+TEST_F(QueryTest, AveragesByWeekday)
+{
+    auto result = Query::run(Query::parse("avg(hours) where date >= 2025-01-01 and date <= 2025-12-31 by weekday"), clients);
+
+    ASSERT_EQ(result.rows.size(), 2u);
+    EXPECT_EQ(result.rows[0].keys[0], "Mon");
+    EXPECT_DOUBLE_EQ(result.rows[0].values[0], 14.0 / 3);
+    EXPECT_EQ(result.rows[1].keys[0], "Tue");
+    EXPECT_DOUBLE_EQ(result.rows[1].values[0], 4.5);
+}
+
+TEST_F(QueryTest, MoneyUsesEachClientsRate)
+{
+    auto result = Query::run(Query::parse("SUM(amount), sum(total), max(amount) by year, client"), clients);
+
+    ASSERT_EQ(result.rows.size(), 3u);
+    EXPECT_EQ(result.rows[0].keys, (std::vector<std::string>{"2025", "acme"}));
+    EXPECT_DOUBLE_EQ(result.rows[0].values[0], 1800.0);
+    EXPECT_DOUBLE_EQ(result.rows[0].values[1], 1800.0 * 1.21);
+    EXPECT_DOUBLE_EQ(result.rows[0].values[2], 800.0);
+    EXPECT_EQ(result.rows[1].keys, (std::vector<std::string>{"2025", "beta"}));
+    EXPECT_DOUBLE_EQ(result.rows[1].values[0], 250.0);
+    EXPECT_EQ(result.rows[2].keys, (std::vector<std::string>{"2026", "acme"}));
+
+    auto total = Query::run(Query::parse("sum(amount) where client != beta"), clients);
+    ASSERT_EQ(total.rows.size(), 1u);
+    EXPECT_TRUE(total.rows[0].keys.empty());
+    EXPECT_DOUBLE_EQ(total.rows[0].values[0], 2000.0);
+}
+
+TEST_F(QueryTest, ReportsParseErrors)
+{
+    EXPECT_THROW(Query::parse(""), std::runtime_error);
+    EXPECT_THROW(Query::parse("sum(minutes)"), std::runtime_error);
+    EXPECT_THROW(Query::parse("sum(hours) where tag > A"), std::runtime_error);
+    EXPECT_THROW(Query::parse("sum(hours) where date = 2025-02-30"), std::runtime_error);
+    EXPECT_THROW(Query::parse("sum(hours) by year, month, date"), std::runtime_error);
+    EXPECT_THROW(Query::parse("sum(hours) order by month"), std::runtime_error);
+
+    Query::Plan plan = Query::parse("count where weekday = Friday and month = 2025-03 and hours > 1.5");
+    ASSERT_EQ(plan.filters.size(), 3u);
+    EXPECT_DOUBLE_EQ(plan.filters[0].number, 4.0);
+    EXPECT_DOUBLE_EQ(plan.filters[1].number, 202503.0);
+    EXPECT_EQ(plan.filters[2].op, Query::Op::Gt);
+}
+
+TEST_F(QueryTest, LoadsArchivedMonthsFromStorage)
+{
+    std::string test_dir = TestRoot::unique_dir("wlog_test_query");
+    TestRoot root;
+    fs::create_directories(test_dir);
+    root.bind(test_dir);
+    ConfigManager::ensure_directories();
+
+    for (const auto &[id, data] : clients)
+        ClientManager::save(id, data);
+    ArchiveManager::archive_client("acme", "2025-06");
+
+    auto result = Query::run("sum(hours) by tag");
+    ASSERT_EQ(result.rows.size(), 2u);
+    EXPECT_EQ(result.rows[0].keys[0], "ACME");
+    EXPECT_DOUBLE_EQ(result.rows[0].values[0], 20.0);
+    EXPECT_DOUBLE_EQ(result.rows[1].values[0], 5.0);
+
+    fs::remove_all(test_dir);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/registry.hpp"
+#include "storage/durable_file.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class RegistryTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_registry");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(RegistryTest, EmptyWithoutClients)
+{
+    EXPECT_TRUE(ClientRegistry::load().empty());
+}
+
+TEST_F(RegistryTest, SaveUpdatesRegistry)
+{
+    ClientData client;
+    client.name = "Registry Client";
+    client.tag = "REG";
+    client.hourly_rate = 90.0;
+    ClientManager::save("regclient", client);
+
+    auto registry = ClientRegistry::load();
+    ASSERT_EQ(registry.count("regclient"), 1u);
+    EXPECT_EQ(registry["regclient"].name, "Registry Client");
+    EXPECT_EQ(registry["regclient"].tag, "REG");
+    EXPECT_EQ(registry["regclient"].hourly_rate, 90.0);
+    EXPECT_TRUE(registry["regclient"].last_month.empty());
+}
+
+TEST_F(RegistryTest, TracksLastActivityMonth)
+{
+    ClientData client;
+    client.name = "Activity Client";
+    client.tag = "ACT";
+    ClientManager::save("actclient", client);
+
+    ClientManager::add_work_log("actclient", "2026-02-03", 8.0, "Work");
+    ClientManager::add_work_log("actclient", "2026-01-15", 8.0, "Backdated");
+
+    EXPECT_EQ(ClientRegistry::load()["actclient"].last_month, "2026-02");
+}
+
+TEST_F(RegistryTest, RebuildsWhenMissing)
+{
+    ClientData client;
+    client.name = "Rebuild Client";
+    client.tag = "RBC";
+    client.logs["2025-12"]["2025-12-01"] = {4.0, "Work"};
+    ClientManager::save("rebuildclient", client);
+
+    fs::remove(ClientRegistry::get_registry_path());
+
+    auto registry = ClientRegistry::load();
+    ASSERT_EQ(registry.count("rebuildclient"), 1u);
+    EXPECT_EQ(registry["rebuildclient"].last_month, "2025-12");
+    EXPECT_TRUE(fs::exists(ClientRegistry::get_registry_path()));
+}
+
+TEST_F(RegistryTest, NotListedAsClient)
+{
+    ClientData client;
+    client.name = "Only Client";
+    ClientManager::save("onlyclient", client);
+
+    EXPECT_EQ(ClientRegistry::load().size(), 1u);
+    EXPECT_FALSE(ClientManager::client_exists("registry"));
+}
+
+TEST_F(RegistryTest, WrittenOncePerBatch)
+{
+    ClientData client;
+    client.name = "First Client";
+    ClientManager::save("first", client);
+
+    {
+        WriteBatch batch;
+        for (int i = 0; i < 3; i++)
+        {
+            client.name = "Batch Client " + std::to_string(i);
+            ClientManager::save("batch" + std::to_string(i), client);
+        }
+
+        // Held until commit, but already visible to readers.
+        std::string pending;
+        EXPECT_FALSE(DurableFile::read_pending(ClientRegistry::get_registry_path(), pending));
+        EXPECT_EQ(ClientRegistry::load().size(), 4u);
+        batch.commit();
+    }
+    EXPECT_EQ(ClientRegistry::load()["batch2"].name, "Batch Client 2");
+
+    {
+        WriteBatch dropped;
+        ClientManager::save("dropped", client);
+    }
+    EXPECT_EQ(ClientRegistry::load().count("dropped"), 0u);
+}
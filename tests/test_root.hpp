@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include "storage/data_root.hpp"
+
+// Gives a test its own data root instead of pointing $HOME somewhere, so
+// test processes can run side by side.
+class TestRoot
+{
+public:
+    // A temp directory named after the test and this process.
+    static std::string unique_dir(const std::string &name)
+    {
+        return (std::filesystem::temp_directory_path() / (name + "_" + std::to_string(getpid()))).string();
+    }
+
+    // Uses home/.wlog, as if $HOME were home, until rebound or destroyed.
+    void bind(const std::string &home)
+    {
+        scope_.reset();
+        root_ = std::make_unique<DataRoot>((std::filesystem::path(home) / ".wlog").string());
+        scope_ = std::make_unique<DataRoot::Scope>(root_.get());
+    }
+
+private:
+    std::unique_ptr<DataRoot> root_;
+    std::unique_ptr<DataRoot::Scope> scope_;
+};
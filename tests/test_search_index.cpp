@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/archive.hpp"
+#include "storage/durable_file.hpp"
+#include "storage/search_index.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class SearchIndexTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_search");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        ClientData acme;
+        acme.name = "Acme";
+        acme.logs["2024-03"]["2024-03-04"] = {2.5, "Fix login bug TICKET-42"};
+        acme.logs["2026-01"]["2026-01-05"] = {8.0, "ticket-42 follow-up"};
+        acme.logs["2026-01"]["2026-01-06"] = {4.0, "Standup"};
+        ClientManager::save("acme", acme);
+
+        ClientData beta;
+        beta.name = "Beta";
+        beta.logs["2026-02"]["2026-02-02"] = {1.5, "Review of ticket 42"};
+        ClientManager::save("beta", beta);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST(SearchTokenizeTest, LowercasesAndSplitsOnPunctuation)
+{
+    std::vector<std::string> expected = {"fix", "ticket", "42", "café"};
+    EXPECT_EQ(SearchIndex::tokenize("Fix TICKET-42, ticket 42 (café)"), expected);
+    EXPECT_TRUE(SearchIndex::tokenize(" - ").empty());
+}
+
+TEST_F(SearchIndexTest, MatchesAllTermsAcrossClients)
+{
+    auto results = SearchIndex::search("Ticket-42");
+    EXPECT_TRUE(fs::exists(SearchIndex::get_index_path()));
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].client_id, "acme");
+    EXPECT_EQ(results[0].date, Calendar::Date(2024, 3, 4));
+    EXPECT_EQ(results[2].client_id, "beta");
+    EXPECT_EQ(results[2].message, "Review of ticket 42");
+
+    EXPECT_EQ(SearchIndex::search("login ticket").size(), 1u);
+    EXPECT_TRUE(SearchIndex::search("ticket missing").empty());
+    EXPECT_THROW(SearchIndex::search("--"), std::runtime_error);
+}
+
+TEST_F(SearchIndexTest, FiltersByClientAndRange)
+{
+    EXPECT_EQ(SearchIndex::search("ticket", "beta").size(), 1u);
+
+    auto results = SearchIndex::search("ticket", "", Calendar::Date(2026, 1, 1), Calendar::Date(2026, 1, 31));
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_DOUBLE_EQ(results[0].hours, 8.0);
+}
+
+TEST_F(SearchIndexTest, RecordsNewLogsAndDropsOverwrittenOnes)
+{
+    SearchIndex::search("ticket");
+
+    ClientManager::add_work_log("beta", "2026-02-03", 3.0, "Deploy ticket 42");
+    EXPECT_TRUE(fs::exists(SearchIndex::get_journal_path()));
+    EXPECT_EQ(SearchIndex::search("deploy").size(), 1u);
+
+    ClientManager::add_work_log("acme", "2026-01-05", 8.0, "Planning");
+    auto results = SearchIndex::search("ticket", "acme");
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].date, Calendar::Date(2024, 3, 4));
+}
+
+TEST_F(SearchIndexTest, JournalFoldsIntoIndex)
+{
+    SearchIndex::search("ticket");
+
+    for (size_t i = 0; i < SearchIndex::JOURNAL_LIMIT; i++)
+    {
+        Calendar::Date date = Calendar::add_days(Calendar::Date(2025, 1, 1), static_cast<int>(i));
+        ClientManager::add_work_log("beta", Calendar::iso(date).str(), 1.0, "Batch item");
+    }
+
+    EXPECT_FALSE(fs::exists(SearchIndex::get_journal_path()));
+    EXPECT_EQ(SearchIndex::search("batch item", "beta").size(), SearchIndex::JOURNAL_LIMIT);
+}
+
+TEST_F(SearchIndexTest, ForgottenEntriesStayGoneAfterFolding)
+{
+    SearchIndex::search("ticket");
+
+    ClientManager::add_work_log("acme", "2026-01-07", 1.0, "Ticket triage");
+    SearchIndex::forget("acme", Calendar::Date(2026, 1, 1), Calendar::Date(2026, 1, 31));
+    SearchIndex::record("acme", Calendar::Date(2026, 1, 6), 4.0, "Standup");
+
+    auto check = [] {
+        auto results = SearchIndex::search("ticket", "acme");
+        ASSERT_EQ(results.size(), 1u);
+        EXPECT_EQ(results[0].date, Calendar::Date(2024, 3, 4));
+        EXPECT_EQ(SearchIndex::search("standup").size(), 1u);
+    };
+    check();
+
+    // The three lines above plus these fill the journal.
+    for (size_t i = 0; i < SearchIndex::JOURNAL_LIMIT - 3; i++)
+    {
+        Calendar::Date date = Calendar::add_days(Calendar::Date(2025, 1, 1), static_cast<int>(i));
+        ClientManager::add_work_log("beta", Calendar::iso(date).str(), 1.0, "Batch item");
+    }
+    EXPECT_FALSE(fs::exists(SearchIndex::get_journal_path()));
+    check();
+}
+
+TEST_F(SearchIndexTest, RebuildCoversArchive)
+{
+    ArchiveManager::archive_client("acme", "2025-01");
+    SearchIndex::rebuild();
+
+    auto results = SearchIndex::search("login");
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_DOUBLE_EQ(results[0].hours, 2.5);
+
+    DurableFile::write(SearchIndex::get_index_path(), "garbage");
+    EXPECT_THROW(SearchIndex::search("login"), std::runtime_error);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/search_index.hpp"
+#include "storage/sync.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class SyncTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+    std::string laptop;
+    std::string desktop;
+    std::string shared;
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_sync");
+        laptop = test_dir + "/laptop";
+        desktop = test_dir + "/desktop";
+        shared = test_dir + "/shared";
+        fs::create_directories(shared);
+
+        use(desktop);
+        use(laptop);
+        ClientData acme;
+        acme.name = "Acme";
+        acme.hourly_rate = 95.0;
+        acme.logs["2026-01"]["2026-01-05"] = {8.0, "Setup"};
+        acme.logs["2026-02"]["2026-02-02"] = {4.0, "Kickoff"};
+        ClientManager::save("acme", acme);
+    }
+
+    void use(const std::string &home)
+    {
+        root.bind(home);
+        ConfigManager::ensure_directories();
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(SyncTest, PushesAndPullsClients)
+{
+    SyncResult pushed = SyncManager::run(shared);
+    EXPECT_EQ(pushed.clients, 1u);
+    EXPECT_EQ(pushed.pushed, 2u);
+    EXPECT_TRUE(fs::exists(shared + "/clients/acme/2026-02.json"));
+
+    use(desktop);
+    SyncResult pulled = SyncManager::run(shared);
+    EXPECT_EQ(pulled.pulled, 2u);
+
+    ClientData acme = ClientManager::load("acme");
+    EXPECT_EQ(acme.name, "Acme");
+    EXPECT_DOUBLE_EQ(acme.hourly_rate, 95.0);
+    EXPECT_EQ(acme.logs.size(), 2u);
+    EXPECT_EQ(SyncManager::month_hash(acme.logs, "2026-02"), [&]
+    {
+        use(laptop);
+        return SyncManager::month_hash(ClientManager::load("acme").logs, "2026-02");
+    }());
+}
+
+TEST_F(SyncTest, OnlyChangedMonthsMove)
+{
+    SyncManager::run(shared);
+    EXPECT_EQ(SyncManager::run(shared).clients, 0u);
+
+    ClientManager::add_work_log("acme", "2026-02-03", 2.0, "Follow-up");
+    auto january = fs::last_write_time(shared + "/clients/acme/2026-01.json");
+
+    SyncResult result = SyncManager::run(shared);
+    EXPECT_EQ(result.pushed, 1u);
+    EXPECT_EQ(fs::last_write_time(shared + "/clients/acme/2026-01.json"), january);
+}
+
+TEST_F(SyncTest, ConcurrentEditsMergePerDate)
+{
+    SyncManager::run(shared);
+    use(desktop);
+    SyncManager::run(shared);
+
+    ClientManager::add_work_log("acme", "2026-02-04", 3.0, "Desktop work");
+    ClientManager::add_work_log("acme", "2026-02-02", 5.0, "Kickoff, longer");
+    SyncManager::run(shared);
+
+    use(laptop);
+    ClientManager::add_work_log("acme", "2026-02-05", 1.0, "Laptop work");
+    ClientManager::add_work_log("acme", "2026-02-02", 4.5, "Kickoff, edited");
+    SyncResult result = SyncManager::run(shared);
+    EXPECT_EQ(result.merged, 1u);
+
+    ClientData laptop_data = ClientManager::load("acme");
+    EXPECT_EQ(laptop_data.logs.month("2026-02").size(), 3u);
+    EXPECT_DOUBLE_EQ(laptop_data.logs.between(Calendar::Date(2026, 2, 2), Calendar::Date(2026, 2, 2)).total_hours(), 5.0);
+
+    use(desktop);
+    SyncManager::run(shared);
+    ClientData desktop_data = ClientManager::load("acme");
+    EXPECT_EQ(SyncManager::month_hash(desktop_data.logs, "2026-02"),
+              SyncManager::month_hash(laptop_data.logs, "2026-02"));
+}
+
+TEST_F(SyncTest, ShardedClientReadsOnlyChangedYears)
+{
+    ClientManager::set_layout(ClientLayout::Sharded);
+    ClientData acme = ClientManager::load("acme");
+    acme.logs["2025-11"]["2025-11-20"] = {6.0, "Audit"};
+    ClientManager::save("acme", acme);
+    SyncManager::run(shared);
+
+    // A 2025 shard that can't be parsed but looks untouched must never be read.
+    std::string shard = ClientManager::get_shard_path("acme", "2025");
+    auto written = fs::last_write_time(shard);
+    std::string blank(fs::file_size(shard), ' ');
+    std::ofstream(shard) << blank;
+    fs::last_write_time(shard, written);
+
+    ClientManager::add_work_log("acme", "2026-02-03", 2.0, "Follow-up");
+    EXPECT_EQ(SyncManager::run(shared).pushed, 1u);
+
+    use(desktop);
+    EXPECT_EQ(SyncManager::run(shared).pulled, 3u);
+    EXPECT_EQ(ClientManager::load("acme").logs.size(), 4u);
+    ClientManager::add_work_log("acme", "2026-01-06", 3.0, "Desktop work");
+    SyncManager::run(shared);
+
+    use(laptop);
+    ClientManager::set_layout(ClientLayout::Sharded);
+    EXPECT_EQ(SyncManager::run(shared).pulled, 1u);
+    ClientData laptop_data = ClientManager::load_years("acme", {"2026"});
+    EXPECT_EQ(laptop_data.logs.month("2026-01").size(), 2u);
+    EXPECT_EQ(laptop_data.logs.month("2026-02").size(), 2u);
+    EXPECT_EQ(fs::last_write_time(shard), written);
+}
+
+TEST_F(SyncTest, PulledMonthDropsDeletedDatesFromSearch)
+{
+    SyncManager::run(shared);
+    use(desktop);
+    SyncManager::run(shared);
+    EXPECT_EQ(SearchIndex::search("kickoff").size(), 1u);
+
+    use(laptop);
+    ClientData acme = ClientManager::load("acme");
+    acme.logs.erase(Calendar::Date(2026, 2, 1), Calendar::Date(2026, 2, 28));
+    acme.logs.set("2026-02-09", 2.0, "Retro");
+    ClientManager::save("acme", acme);
+    SyncManager::run(shared);
+
+    use(desktop);
+    EXPECT_EQ(SyncManager::run(shared).pulled, 1u);
+    EXPECT_TRUE(SearchIndex::search("kickoff").empty());
+    EXPECT_EQ(SearchIndex::search("retro").size(), 1u);
+}
+
+TEST_F(SyncTest, DetailsFollowTheirLastEdit)
+{
+    SyncManager::run(shared);
+    use(desktop);
+    SyncManager::run(shared);
+
+    ClientData acme = ClientManager::load("acme");
+    acme.hourly_rate = 110.0;
+    ClientManager::save("acme", acme);
+    EXPECT_EQ(SyncManager::run(shared).clients, 1u);
+
+    use(laptop);
+    EXPECT_EQ(SyncManager::run(shared).clients, 1u);
+    EXPECT_DOUBLE_EQ(ClientManager::load("acme").hourly_rate, 110.0);
+    EXPECT_EQ(SyncManager::run(shared).clients, 0u);
+
+    ClientData laptop_data = ClientManager::load("acme");
+    laptop_data.address_line1 = "Main Street 1";
+    ClientManager::save("acme", laptop_data);
+    SyncManager::run(shared);
+
+    use(desktop);
+    SyncManager::run(shared);
+    ClientData desktop_data = ClientManager::load("acme");
+    EXPECT_EQ(desktop_data.address_line1, "Main Street 1");
+    EXPECT_DOUBLE_EQ(desktop_data.hourly_rate, 110.0);
+    EXPECT_EQ(desktop_data.logs.size(), 2u);
+}
+
+TEST_F(SyncTest, DetailsEditedOnBothSidesAgree)
+{
+    SyncManager::run(shared);
+    use(desktop);
+    SyncManager::run(shared);
+    ClientData acme = ClientManager::load("acme");
+    acme.hourly_rate = 120.0;
+    ClientManager::save("acme", acme);
+    SyncManager::run(shared);
+
+    use(laptop);
+    acme = ClientManager::load("acme");
+    acme.hourly_rate = 105.0;
+    ClientManager::save("acme", acme);
+    SyncManager::run(shared);
+    double laptop_rate = ClientManager::load("acme").hourly_rate;
+
+    use(desktop);
+    SyncManager::run(shared);
+    EXPECT_DOUBLE_EQ(ClientManager::load("acme").hourly_rate, laptop_rate);
+}
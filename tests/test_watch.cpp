@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "command/watch.hpp"
+#include "storage/config.hpp"
+#include "storage/client.hpp"
+#include "storage/watcher.hpp"
+#include "test_root.hpp"
+
+namespace fs = std::filesystem;
+
+class WatchTest : public ::testing::Test
+{
+protected:
+    std::string test_dir;
+    TestRoot root;
+    Calendar::Date today = Calendar::Date(2026, 3, 10);
+
+    void SetUp() override
+    {
+        test_dir = TestRoot::unique_dir("wlog_test_watch");
+        fs::create_directories(test_dir);
+        root.bind(test_dir);
+        ConfigManager::ensure_directories();
+
+        ClientData acme;
+        acme.name = "Acme";
+        acme.logs["2026-02"]["2026-02-27"] = {6.0, "Last month"};
+        acme.logs["2026-03"]["2026-03-02"] = {4.0, "Planning"};
+        acme.logs["2026-03"]["2026-03-10"] = {2.5, "Review"};
+        ClientManager::save("acme", acme);
+
+        ClientData beta;
+        beta.name = "Beta";
+        beta.logs["2026-03"]["2026-03-09"] = {1.5, "Call"};
+        ClientManager::save("beta", beta);
+    }
+
+    void TearDown() override
+    {
+        ClientManager::set_layout(ClientLayout::SingleFile);
+        fs::remove_all(test_dir);
+    }
+};
+
+TEST_F(WatchTest, SummaryRefreshesOneClientAtATime)
+{
+    WatchSummary summary(today);
+    EXPECT_EQ(summary.client_count(), 2u);
+    EXPECT_DOUBLE_EQ(summary.today_total(), 2.5);
+    EXPECT_DOUBLE_EQ(summary.month_total(), 8.0);
+
+    ClientManager::add_work_log("beta", "2026-03-10", 3.0, "Workshop");
+    summary.refresh("beta");
+    EXPECT_DOUBLE_EQ(summary.today_total(), 5.5);
+    EXPECT_DOUBLE_EQ(summary.month_total(), 11.0);
+
+    fs::remove(ClientManager::get_client_path("acme"));
+    summary.refresh("acme");
+    EXPECT_EQ(summary.client_count(), 1u);
+    EXPECT_DOUBLE_EQ(summary.today_total(), 3.0);
+    EXPECT_DOUBLE_EQ(summary.month_total(), 4.5);
+
+    std::ostringstream out;
+    summary.render(out);
+    EXPECT_NE(out.str().find("Beta"), std::string::npos);
+    EXPECT_EQ(out.str().find("Acme"), std::string::npos);
+}
+
+TEST_F(WatchTest, WatcherReportsSavedClients)
+{
+    if (!ClientWatcher::available())
+        GTEST_SKIP() << "inotify not available";
+
+    ClientManager::set_layout(ClientLayout::Sharded);
+    ClientData gamma;
+    gamma.name = "Gamma";
+    gamma.logs["2026-03"]["2026-03-10"] = {1.0, "Kickoff"};
+    ClientManager::save("gamma", gamma);
+
+    ClientWatcher watcher;
+    EXPECT_TRUE(watcher.wait(0).empty());
+
+    ClientManager::add_work_log("beta", "2026-03-10", 1.0, "Follow-up");
+    EXPECT_EQ(watcher.wait(1000), std::set<std::string>{"beta"});
+
+    ClientManager::add_work_log("gamma", "2026-03-11", 2.0, "Design");
+    EXPECT_EQ(watcher.wait(1000), std::set<std::string>{"gamma"});
+}
+
+TEST_F(WatchTest, WatcherReportsQueueOverflow)
+{
+    std::ifstream limit_file("/proc/sys/fs/inotify/max_queued_events");
+    int limit = 0;
+    if (!ClientWatcher::available() || !(limit_file >> limit) || limit > 100000)
+        GTEST_SKIP() << "inotify queue limit not usable";
+
+    ClientWatcher watcher;
+    EXPECT_TRUE(watcher.wait(0).empty());
+    EXPECT_FALSE(watcher.overflowed());
+
+    // Alternate two files so the kernel can't merge consecutive events.
+    std::string dir = ConfigManager::get_clients_dir();
+    for (int i = 0; i <= limit; i++)
+        std::ofstream(dir + (i % 2 ? "/noise-a.txt" : "/noise-b.txt")) << i;
+
+    watcher.wait(1000);
+    EXPECT_TRUE(watcher.overflowed());
+
+    ClientManager::add_work_log("beta", "2026-03-10", 1.0, "Follow-up");
+    EXPECT_EQ(watcher.wait(1000), std::set<std::string>{"beta"});
+    EXPECT_FALSE(watcher.overflowed());
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 #include <filesystem>
+#include <fstream>
 #include "storage/config.hpp"
 #include "storage/client.hpp"
 #include "report/work_log.hpp"
+#include "test_root.hpp"
 
 namespace fs = std::filesystem;
 
@@ -10,13 +12,14 @@ class WorkLogTest : public ::testing::Test
 {
 protected:
     std::string test_dir;
+    TestRoot root;
     std::string original_cwd;
 
     void SetUp() override
     {
-        test_dir = fs::temp_directory_path() / "wlog_test_worklog";
+        test_dir = TestRoot::unique_dir("wlog_test_worklog");
         fs::create_directories(test_dir);
-        setenv("HOME", test_dir.c_str(), 1);
+        root.bind(test_dir);
 
         original_cwd = fs::current_path();
         fs::current_path(test_dir);
@@ -130,3 +133,32 @@ TEST_F(WorkLogTest, EntriesSortedByDate)
     std::string output = WorkLogReport::generate("sortclient", "2026-04");
     EXPECT_TRUE(fs::exists(test_dir + "/" + output));
 }
+
+TEST_F(WorkLogTest, RendersHtmlAndMarkdown)
+{
+    ClientData client = ClientManager::load("worklogclient");
+    client.logs["2026-01"]["2026-01-08"] = {1.0, "Fix <script> & a|b *bold*"};
+    ClientManager::save("worklogclient", client);
+
+    std::string html = WorkLogReport::generate("worklogclient", "2026-01", WorkLogReport::parse_format("html"));
+    EXPECT_EQ(html, "worklog-worklogclient-2026-01.html");
+    std::ifstream html_file(test_dir + "/" + html);
+    std::string page((std::istreambuf_iterator<char>(html_file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(page.rfind("<!DOCTYPE html>", 0), 0u);
+    EXPECT_NE(page.find("<td class=\"date\">Jan 05, 2026</td><td class=\"number\">8.0</td><td>Short message</td>"),
+              std::string::npos);
+    EXPECT_NE(page.find("Fix &lt;script&gt; &amp; a|b *bold*"), std::string::npos);
+    EXPECT_NE(page.find("€ 1575.00"), std::string::npos);
+    EXPECT_NE(page.find("</html>"), std::string::npos);
+
+    std::string md = WorkLogReport::generate("worklogclient", "2026-01", WorkLogReport::parse_format("md"));
+    EXPECT_EQ(md, "worklog-worklogclient-2026-01.md");
+    std::ifstream md_file(test_dir + "/" + md);
+    std::string text((std::istreambuf_iterator<char>(md_file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(text.find("| Jan 08, 2026 | 1.0 | Fix \\<script\\> & a\\|b \\*bold\\* |"), std::string::npos);
+    EXPECT_NE(text.find("| **Total** | **€ 1905.75** |"), std::string::npos);
+
+    EXPECT_THROW(WorkLogReport::parse_format("docx"), std::runtime_error);
+    EXPECT_THROW(WorkLogReport::generate("worklogclient", "2025-01", ReportFormat::Html), std::runtime_error);
+    EXPECT_FALSE(fs::exists(test_dir + "/worklog-worklogclient-2025-01.html"));
+}
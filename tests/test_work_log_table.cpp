@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "storage/work_log_table.hpp"
+#include "storage/arena.hpp"
+#include "storage/parallel.hpp"
+
+TEST(WorkLogTableTest, KeepsRowsSortedByDate)
+{
+    WorkLogTable table;
+    table.set("2026-02-03", 2.0, "Feb");
+    table.set("2026-01-20", 4.0, "Late Jan");
+    table.set("2026-01-05", 8.0, "Early Jan");
+
+    std::pmr::vector<uint32_t> expected = {20260105, 20260120, 20260203};
+    EXPECT_EQ(table.dates(), expected);
+    EXPECT_EQ(table.month("2026-01").size(), 2u);
+    EXPECT_DOUBLE_EQ(table.month("2026-01").total_hours(), 12.0);
+    EXPECT_TRUE(table.month("2026-03").empty());
+}
+
+TEST(WorkLogTableTest, AcceptsStoredDatesTheCalendarRejects)
+{
+    WorkLogTable table;
+    table.set("2026-02-30", 1.0, "Logged before validation");
+    EXPECT_EQ(table.month("2026-02").size(), 1u);
+    EXPECT_THROW(table.set("2026-02-32", 1.0, ""), std::runtime_error);
+}
+
+TEST(WorkLogTableTest, OverwriteReplacesEntry)
+{
+    WorkLogTable table;
+    table.set("2026-01-05", 8.0, "A much longer first message");
+    table.set("2026-01-05", 6.0, "Short");
+    table.set("2026-01-06", 1.0, "Next");
+    table.set("2026-01-05", 5.0, "Now longer than both before");
+
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_DOUBLE_EQ(table.row(0).hours, 5.0);
+    EXPECT_EQ(table.row(0).message, "Now longer than both before");
+    EXPECT_EQ(table.row(1).message, "Next");
+}
+
+TEST(WorkLogTableTest, JsonKeepsNestedLayout)
+{
+    nlohmann::json j = {
+        {"2026-01", {{"2026-01-15", {{"hours", 8.0}, {"message", "Dev"}}}}},
+        {"2026-02", {{"2026-02-01", {{"hours", 2.5}, {"message", "Call"}}}}}};
+
+    WorkLogTable table = j.get<WorkLogTable>();
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(nlohmann::json(table), j);
+}
+
+TEST(WorkLogTableTest, MergeSliceAndErase)
+{
+    WorkLogTable table;
+    table.set("2025-12-01", 1.0, "Old");
+    table.set("2026-01-01", 2.0, "New");
+
+    WorkLogTable other;
+    other.set("2026-01-01", 9.0, "Other");
+    other.set("2026-01-02", 3.0, "Extra");
+
+    table.merge(other, false);
+    EXPECT_DOUBLE_EQ(table.month("2026-01").total_hours(), 5.0);
+
+    Calendar::Date end_of_2025(2025, 12, 31);
+    WorkLogTable old = table.slice(Calendar::Date(), end_of_2025);
+    EXPECT_EQ(old.size(), 1u);
+
+    table.erase(Calendar::Date(), end_of_2025);
+    EXPECT_EQ(table.first_date(), Calendar::Date(2026, 1, 1));
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(WorkLogTableTest, InternsRepeatedMessages)
+{
+    WorkLogTable table;
+    table.set("2026-01-05", 1.0, "Standup");
+    table.set("2026-01-06", 1.0, "Standup");
+    table.set("2026-01-07", 2.0, "Code review");
+
+    ASSERT_TRUE(table.pool());
+    EXPECT_EQ(table.pool()->size(), 2u);
+    EXPECT_EQ(table.row(0).message.data(), table.row(1).message.data());
+}
+
+TEST(WorkLogTableTest, SharePoolReinternsMessages)
+{
+    WorkLogTable a;
+    a.set("2026-01-05", 1.0, "Standup");
+    WorkLogTable b;
+    b.set("2026-01-05", 1.0, "Standup");
+    b.set("2026-01-06", 1.0, "Review");
+
+    auto pool = std::make_shared<MessagePool>();
+    a.share_pool(pool);
+    b.share_pool(pool);
+
+    EXPECT_EQ(pool->size(), 2u);
+    EXPECT_EQ(a.row(0).message.data(), b.row(0).message.data());
+    EXPECT_EQ(b.row(1).message, "Review");
+}
+
+TEST(WorkLogTableTest, DictionaryEncodingRoundTrip)
+{
+    WorkLogTable table;
+    table.set("2026-01-05", 1.0, "Standup");
+    table.set("2026-01-06", 2.0, "Standup");
+    table.set("2026-02-02", 3.0, "Review");
+
+    WorkLogTable::set_encoding(MessageEncoding::Dictionary);
+    nlohmann::json j = table;
+    WorkLogTable::set_encoding(MessageEncoding::Inline);
+
+    ASSERT_TRUE(j.contains("messages"));
+    EXPECT_EQ(j["messages"].size(), 2u);
+    EXPECT_EQ(j["2026-01"]["2026-01-06"]["message"], 0);
+
+    WorkLogTable loaded = j.get<WorkLogTable>();
+    EXPECT_EQ(nlohmann::json(loaded), nlohmann::json(table));
+}
+
+TEST(WorkLogTableTest, AllocatesFromCommandArena)
+{
+    std::pmr::memory_resource *heap = std::pmr::get_default_resource();
+    {
+        CommandArena arena;
+        EXPECT_NE(std::pmr::get_default_resource(), heap);
+
+        WorkLogTable table;
+        table.set("2026-01-05", 8.0, "Arena backed");
+        EXPECT_GT(arena.bytes_allocated(), 0u);
+        EXPECT_EQ(table.row(0).message, "Arena backed");
+    }
+    EXPECT_EQ(std::pmr::get_default_resource(), heap);
+}
+
+TEST(WorkLogTableTest, WorkerThreadsAllocateFromCommandArena)
+{
+    CommandArena arena;
+    std::vector<WorkLogTable> tables(8);
+    parallel_for(tables.size(), 4, [&](size_t i) {
+        for (int day = 1; day <= 28; day++)
+        {
+            char date[16];
+            std::snprintf(date, sizeof(date), "2026-02-%02d", day);
+            tables[i].set(date, 1.0 + i, "Worker " + std::to_string(i));
+        }
+    });
+
+    size_t bytes = arena.bytes_allocated();
+    EXPECT_GT(bytes, 0u);
+    for (size_t i = 0; i < tables.size(); i++)
+    {
+        EXPECT_EQ(tables[i].size(), 28u);
+        EXPECT_EQ(tables[i].row(27).message, "Worker " + std::to_string(i));
+    }
+}